@@ -11,10 +11,10 @@
 #include "spritesheet_bird_8x8.h"
 #include "spritesheet_dancer_8x8.h"
 #include "spritesheet_flame_8x8.h"
-#include "spritesheet_ghost_8x8.h"
-#include "spritesheet_heart_8x8.h"
-#include "spritesheet_ripple_8x8.h"
-#include "spritesheet_tribal_8x8.h"
+#include "spritesheet_ghost_8x8_packed.h"
+#include "spritesheet_heart_8x8_packed.h"
+#include "spritesheet_ripple_8x8_packed.h"
+#include "spritesheet_tribal_8x8_packed.h"
 
 #define WS2812B_PIN   2         // The GPIO pin connected to the WS2812B data pin.
 #define NUM_PIXELS   64         // The number of pixels in your strip or matrix.
@@ -216,16 +216,18 @@ int main() {
     FX_t* dancer_animation = ws2812b_spritesheet(SPRITESHEET_DANCER_8X8, 4, 200, 3);
     while (dancer_animation->running){ sleep_ms(10); }
 
-    FX_t* ghost_animation = ws2812b_spritesheet(SPRITESHEET_GHOST_8X8, 6, 200, 3);
+    // Spritesheets packed with tools/img2grb.py -s store a palette and compressed frames,
+    // and know their number of frames.
+    FX_t* ghost_animation = ws2812b_spritesheet_packed(&SPRITESHEET_GHOST_8X8_PACKED, 200, 3);
     while (ghost_animation->running){ sleep_ms(10); }
 
-    FX_t* heart_animation = ws2812b_spritesheet(SPRITESHEET_HEART_8X8, 3, 200, 3);
+    FX_t* heart_animation = ws2812b_spritesheet_packed(&SPRITESHEET_HEART_8X8_PACKED, 200, 3);
     while (heart_animation->running){ sleep_ms(10); }
 
-    FX_t* ripple_animation = ws2812b_spritesheet(SPRITESHEET_RIPPLE_8X8, 8, 200, 3);
+    FX_t* ripple_animation = ws2812b_spritesheet_packed(&SPRITESHEET_RIPPLE_8X8_PACKED, 200, 3);
     while (ripple_animation->running){ sleep_ms(10); }
 
-    FX_t* tribal_animation = ws2812b_spritesheet(SPRITESHEET_TRIBAL_8X8, 2, 200, 8);
+    FX_t* tribal_animation = ws2812b_spritesheet_packed(&SPRITESHEET_TRIBAL_8X8_PACKED, 200, 8);
     // Finally, you can set a callback function to be executed as the animation completes.
     // Callbacks are available for effects invoked with ws2812b_animate(), ws2812b_text_type(),
     // ws2812b_text_scroll(), and ws2812b_spritesheet().
@@ -0,0 +1,76 @@
+/**
+ * @file CP0_EU_lookup.h
+ * @brief Code point to glyph index lookup for the CP0-EU character set.
+ * @details Generated by tools/cp0eu2lookup.py from CHARMAP_CP0_EU, do not edit.
+ */
+
+#ifndef CP0_EU_LOOKUP_H
+#define CP0_EU_LOOKUP_H
+
+#include <stdint.h>
+
+#define CP0_EU_FALLBACK_GLYPH 215
+
+static const uint8_t CP0_EU_LATIN1[256] = { // U+0000-U+00FF
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+      0,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,
+     48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+     64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,
+     80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,
+     96,  97,  98,  99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 127, 215, 247, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    190, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 191,
+    192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+    208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+    224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+    240, 241, 242, 243, 244, 245, 246, 215, 248, 249, 250, 251, 252, 253, 254, 255,
+};
+
+static const uint8_t CP0_EU_LATIN_EXT_A[128] = { // U+0100-U+017F
+    215, 215, 215, 215, 174, 175, 176, 177, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 178, 179, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 180, 181, 182, 183, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 129, 130, 215, 215, 215, 215, 215, 215, 184, 185, 215, 215, 215, 215,
+    131, 132, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 136, 186, 187, 188, 189, 134, 135, 215,
+};
+
+static const uint8_t CP0_EU_GREEK[80] = { // U+0380-U+03CF
+    215, 215, 215, 215, 215, 215,   1, 215,   2,   3,   4, 215,   5, 215,   6,   7,
+      8,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,
+     24,  25, 215,  26,  27,  28,  29,  30,  31,  32, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158,
+    159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 215,
+};
+
+static const struct { uint16_t codepoint; uint8_t glyph; } CP0_EU_OTHERS[3] = {
+    { 0x2022, 215 },
+    { 0x2026, 133 },
+    { 0x20ac, 128 },
+};
+
+/**
+ * @brief Get the glyph index of a code point.
+ * @param codepoint Unicode code point.
+ * @return Index into CP0_EU_8x8, CP0_EU_FALLBACK_GLYPH if the character set lacks the code point.
+ */
+static inline uint8_t cp0_eu_glyph(uint32_t codepoint) {
+    if (codepoint < 0x0100) return CP0_EU_LATIN1[codepoint];
+    if (codepoint >= 0x0100 && codepoint < 0x0180) return CP0_EU_LATIN_EXT_A[codepoint - 0x0100];
+    if (codepoint >= 0x0380 && codepoint < 0x03d0) return CP0_EU_GREEK[codepoint - 0x0380];
+    uint32_t lo = 0, hi = 3;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (CP0_EU_OTHERS[mid].codepoint < codepoint) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < 3 && CP0_EU_OTHERS[lo].codepoint == codepoint) ? CP0_EU_OTHERS[lo].glyph : CP0_EU_FALLBACK_GLYPH;
+}
+
+#endif
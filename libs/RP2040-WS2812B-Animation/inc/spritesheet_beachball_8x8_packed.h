@@ -0,0 +1,35 @@
+static const uGRB32_t SPRITESHEET_BEACHBALL_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x000000ff, 0x0000ffff, 0x0000ff00, 0x00ffffff, 0x0080ff00, 0x00ff00ff, 0x00ffff00, 0x00ff0000, 0x00ff8000,
+};
+
+static const uint16_t SPRITESHEET_BEACHBALL_8X8_PACKED_OFFSETS[]={
+    0, 31, 64, 95, 126, 157, 190, 221,
+};
+
+static const uint8_t SPRITESHEET_BEACHBALL_8X8_PACKED_DATA[]={
+    0x02, 0x10, 0x01, 0x02, 0x13, 0x20, 0x11, 0x02, 0x23, 0x00, 0x21, 0x04, 0x33, 0x21, 0x14, 0x25,
+    0x26, 0x14, 0x27, 0x38, 0x04, 0x27, 0x00, 0x28, 0x09, 0x17, 0x20, 0x18, 0x09, 0x07, 0x10, 0x00,
+    0x00, 0x11, 0x11, 0x00, 0x60, 0x11, 0x11, 0x02, 0x88, 0x16, 0x24, 0x33, 0x88, 0x48, 0x34, 0x33,
+    0x88, 0x48, 0x34, 0x33, 0x88, 0x49, 0x57, 0x33, 0x90, 0x77, 0x77, 0x05, 0x00, 0x77, 0x77, 0x00,
+    0x02, 0x10, 0x08, 0x06, 0x11, 0x20, 0x18, 0x06, 0x21, 0x00, 0x28, 0x06, 0x31, 0x28, 0x24, 0x12,
+    0x19, 0x24, 0x23, 0x37, 0x05, 0x23, 0x00, 0x27, 0x05, 0x13, 0x20, 0x17, 0x05, 0x03, 0x10, 0x02,
+    0x10, 0x38, 0x20, 0x09, 0x38, 0x06, 0x00, 0x17, 0x09, 0x18, 0x06, 0x11, 0x17, 0x24, 0x21, 0x27,
+    0x24, 0x11, 0x17, 0x05, 0x13, 0x02, 0x11, 0x00, 0x05, 0x33, 0x02, 0x20, 0x33, 0x10, 0x02, 0x10,
+    0x07, 0x09, 0x18, 0x20, 0x17, 0x09, 0x28, 0x00, 0x27, 0x04, 0x38, 0x27, 0x14, 0x26, 0x25, 0x14,
+    0x21, 0x33, 0x04, 0x21, 0x00, 0x23, 0x02, 0x11, 0x20, 0x13, 0x02, 0x01, 0x10, 0x00, 0x00, 0x77,
+    0x77, 0x00, 0x50, 0x77, 0x77, 0x09, 0x33, 0x75, 0x94, 0x88, 0x33, 0x43, 0x84, 0x88, 0x33, 0x43,
+    0x84, 0x88, 0x33, 0x42, 0x61, 0x88, 0x20, 0x11, 0x11, 0x06, 0x00, 0x11, 0x11, 0x00, 0x02, 0x10,
+    0x03, 0x05, 0x17, 0x20, 0x13, 0x05, 0x27, 0x00, 0x23, 0x05, 0x37, 0x23, 0x24, 0x19, 0x12, 0x24,
+    0x28, 0x31, 0x06, 0x28, 0x00, 0x21, 0x06, 0x18, 0x20, 0x11, 0x06, 0x08, 0x10, 0x02, 0x10, 0x33,
+    0x20, 0x02, 0x33, 0x05, 0x00, 0x11, 0x02, 0x13, 0x05, 0x17, 0x11, 0x24, 0x27, 0x21, 0x24, 0x17,
+    0x11, 0x06, 0x18, 0x09, 0x17, 0x00, 0x06, 0x38, 0x09, 0x20, 0x38, 0x10,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_BEACHBALL_8X8_PACKED = {
+    .frames = 8,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_BEACHBALL_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_BEACHBALL_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_BEACHBALL_8X8_PACKED_DATA,
+};
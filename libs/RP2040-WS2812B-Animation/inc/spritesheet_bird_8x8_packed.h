@@ -0,0 +1,26 @@
+static const uGRB32_t SPRITESHEET_BIRD_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x000000ff, 0x00ffff00, 0x00ff00ff,
+};
+
+static const uint16_t SPRITESHEET_BIRD_8X8_PACKED_OFFSETS[]={
+    0, 25, 55, 84,
+};
+
+static const uint8_t SPRITESHEET_BIRD_8X8_PACKED_DATA[]={
+    0x02, 0x90, 0x41, 0x30, 0x01, 0x00, 0x01, 0x10, 0x21, 0x02, 0x31, 0x03, 0x51, 0x03, 0x00, 0x03,
+    0x01, 0x13, 0x01, 0x03, 0x20, 0x02, 0x10, 0x02, 0x90, 0x03, 0x1f, 0x41, 0x2f, 0x00, 0x0f, 0x00,
+    0x0f, 0x00, 0x2f, 0x01, 0x02, 0x01, 0x2f, 0x00, 0x1f, 0x01, 0x2f, 0x00, 0x01, 0x03, 0x3f, 0x03,
+    0x01, 0x03, 0x00, 0x3f, 0x00, 0x03, 0xff, 0x02, 0x50, 0x01, 0x20, 0x31, 0x40, 0x01, 0x00, 0x01,
+    0x10, 0x21, 0x02, 0x31, 0x03, 0x51, 0x03, 0x00, 0x03, 0x31, 0x03, 0x20, 0x01, 0x13, 0x01, 0x30,
+    0x02, 0x10, 0x02, 0x10, 0x03, 0x5f, 0x00, 0x2f, 0x30, 0x01, 0x0f, 0x01, 0x0f, 0x01, 0x0f, 0x01,
+    0x1f, 0x01, 0x1f, 0x00, 0x01, 0x00, 0x5f, 0x02, 0xff, 0xbf,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_BIRD_8X8_PACKED = {
+    .frames = 4,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_BIRD_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_BIRD_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_BIRD_8X8_PACKED_DATA,
+};
@@ -0,0 +1,26 @@
+static const uGRB32_t SPRITESHEET_DANCER_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x0000ff00, 0x00ffff00, 0x008000ff,
+};
+
+static const uint16_t SPRITESHEET_DANCER_8X8_PACKED_OFFSETS[]={
+    0, 30, 52, 82,
+};
+
+static const uint8_t SPRITESHEET_DANCER_8X8_PACKED_DATA[]={
+    0x02, 0x20, 0x01, 0x60, 0x21, 0x10, 0x02, 0x00, 0x32, 0x20, 0x02, 0x00, 0x12, 0x40, 0x32, 0x30,
+    0x23, 0x00, 0x02, 0x10, 0x03, 0x10, 0x03, 0x10, 0x02, 0x10, 0x03, 0x10, 0x03, 0x10, 0x02, 0x20,
+    0x31, 0x20, 0x32, 0x40, 0x12, 0x40, 0x32, 0x10, 0x72, 0x10, 0x33, 0x30, 0x03, 0x10, 0x03, 0x30,
+    0x03, 0x10, 0x03, 0x10, 0x02, 0x40, 0x01, 0x40, 0x21, 0x30, 0x32, 0x00, 0x02, 0x20, 0x12, 0x00,
+    0x02, 0x20, 0x32, 0x20, 0x02, 0x00, 0x33, 0x00, 0x02, 0x10, 0x03, 0x10, 0x03, 0x20, 0x03, 0x10,
+    0x03, 0x10, 0x02, 0x20, 0x31, 0x20, 0x32, 0x40, 0x12, 0x40, 0x32, 0x10, 0x72, 0x10, 0x33, 0x30,
+    0x03, 0x10, 0x03, 0x30, 0x03, 0x10, 0x03, 0x10,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_DANCER_8X8_PACKED = {
+    .frames = 4,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_DANCER_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_DANCER_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_DANCER_8X8_PACKED_DATA,
+};
@@ -0,0 +1,28 @@
+static const uGRB32_t SPRITESHEET_FLAME_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x0000ff00, 0x0080ff00, 0x00ffff00, 0x00ffffff,
+};
+
+static const uint16_t SPRITESHEET_FLAME_8X8_PACKED_OFFSETS[]={
+    0, 32, 65, 98,
+};
+
+static const uint8_t SPRITESHEET_FLAME_8X8_PACKED_DATA[]={
+    0x02, 0xa0, 0x01, 0x50, 0x01, 0x02, 0x40, 0x41, 0x10, 0x11, 0x02, 0x03, 0x01, 0x02, 0x01, 0x00,
+    0x01, 0x02, 0x13, 0x02, 0x41, 0x02, 0x14, 0x03, 0x02, 0x10, 0x01, 0x03, 0x14, 0x03, 0x01, 0x00,
+    0x00, 0x00, 0x01, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x10, 0x11, 0x00, 0x01, 0x11, 0x11, 0x20,
+    0x01, 0x11, 0x32, 0x22, 0x12, 0x11, 0x33, 0x34, 0x11, 0x21, 0x42, 0x24, 0x12, 0x10, 0x43, 0x33,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x11, 0x20, 0x01, 0x00, 0x11,
+    0x01, 0x00, 0x11, 0x21, 0x01, 0x01, 0x11, 0x33, 0x12, 0x01, 0x11, 0x42, 0x24, 0x11, 0x10, 0x43,
+    0x33, 0x12, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00,
+    0x21, 0x11, 0x00, 0x10, 0x11, 0x11, 0x01, 0x11, 0x32, 0x12, 0x01, 0x11, 0x32, 0x23, 0x11, 0x10,
+    0x31, 0x34, 0x01,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_FLAME_8X8_PACKED = {
+    .frames = 4,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_FLAME_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_FLAME_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_FLAME_8X8_PACKED_DATA,
+};
@@ -0,0 +1,26 @@
+static const uGRB32_t SPRITESHEET_GHOST_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x000000ff, 0x008000ff, 0x00ffffff,
+};
+
+static const uint16_t SPRITESHEET_GHOST_8X8_PACKED_OFFSETS[]={
+    0, 32, 45, 63, 76, 89,
+};
+
+static const uint8_t SPRITESHEET_GHOST_8X8_PACKED_DATA[]={
+    0x02, 0x90, 0x01, 0x22, 0x20, 0x01, 0x42, 0x00, 0x01, 0x02, 0x13, 0x02, 0x13, 0x02, 0x01, 0x02,
+    0x03, 0x00, 0x02, 0x03, 0x00, 0x02, 0x01, 0x62, 0x01, 0x62, 0x00, 0x12, 0x00, 0x12, 0x00, 0x02,
+    0x03, 0xff, 0xff, 0xff, 0x7f, 0x01, 0x0f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x0f, 0x03, 0xff, 0xff,
+    0x1f, 0x00, 0x03, 0x0f, 0x00, 0x03, 0xff, 0x1f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x0f, 0x00, 0x03,
+    0xff, 0xff, 0xff, 0x7f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x03, 0xff, 0xff, 0xff,
+    0x7f, 0x01, 0x0f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x0f, 0x03, 0xff, 0xff, 0x1f, 0x03, 0x00, 0x0f,
+    0x03, 0x00, 0xff, 0x1f, 0x00, 0x02, 0x0f, 0x00, 0x02, 0x0f, 0x00,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_GHOST_8X8_PACKED = {
+    .frames = 6,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_GHOST_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_GHOST_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_GHOST_8X8_PACKED_DATA,
+};
@@ -0,0 +1,23 @@
+static const uGRB32_t SPRITESHEET_HEART_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x0000ff00, 0x0000ff80, 0x00ffffff,
+};
+
+static const uint16_t SPRITESHEET_HEART_8X8_PACKED_OFFSETS[]={
+    0, 18, 43,
+};
+
+static const uint8_t SPRITESHEET_HEART_8X8_PACKED_DATA[]={
+    0x02, 0xf0, 0x10, 0x01, 0x00, 0x01, 0x30, 0x02, 0x11, 0x03, 0x01, 0x30, 0x02, 0x11, 0x50, 0x02,
+    0xf0, 0x30, 0x02, 0x00, 0x11, 0x00, 0x11, 0x10, 0x02, 0x21, 0x03, 0x11, 0x00, 0x02, 0x51, 0x00,
+    0x02, 0x51, 0x10, 0x02, 0x31, 0x30, 0x02, 0x11, 0x50, 0x02, 0xb0, 0x02, 0x80, 0x11, 0x00, 0x11,
+    0x10, 0x02, 0x21, 0x03, 0x11, 0x00, 0x02, 0x51, 0x10, 0x02, 0x31, 0x40, 0x02, 0xf0, 0x30,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_HEART_8X8_PACKED = {
+    .frames = 3,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_HEART_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_HEART_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_HEART_8X8_PACKED_DATA,
+};
@@ -0,0 +1,34 @@
+static const uGRB32_t SPRITESHEET_RIPPLE_8X8_PACKED_PALETTE[]={
+    0x0080ff00, 0x0000ff80, 0x0000ffff, 0x008000ff, 0x00ff00ff, 0x00ffff00,
+};
+
+static const uint16_t SPRITESHEET_RIPPLE_8X8_PACKED_OFFSETS[]={
+    0, 20, 46, 79, 112, 145, 178, 208,
+};
+
+static const uint8_t SPRITESHEET_RIPPLE_8X8_PACKED_DATA[]={
+    0x02, 0x00, 0x51, 0x00, 0xa1, 0x12, 0x41, 0x02, 0x13, 0x02, 0x31, 0x02, 0x13, 0x02, 0x41, 0x12,
+    0xa1, 0x00, 0x51, 0x00, 0x02, 0x91, 0x32, 0x21, 0x12, 0x13, 0x12, 0x11, 0x02, 0x03, 0x14, 0x03,
+    0x02, 0x11, 0x02, 0x03, 0x14, 0x03, 0x02, 0x11, 0x12, 0x13, 0x12, 0x21, 0x32, 0x91, 0x00, 0x11,
+    0x22, 0x22, 0x11, 0x21, 0x33, 0x33, 0x12, 0x32, 0x43, 0x34, 0x23, 0x32, 0x54, 0x45, 0x23, 0x32,
+    0x54, 0x45, 0x23, 0x32, 0x43, 0x34, 0x23, 0x21, 0x33, 0x33, 0x12, 0x11, 0x22, 0x22, 0x11, 0x00,
+    0x21, 0x33, 0x33, 0x12, 0x32, 0x44, 0x44, 0x23, 0x43, 0x54, 0x45, 0x34, 0x43, 0x05, 0x50, 0x34,
+    0x43, 0x05, 0x50, 0x34, 0x43, 0x54, 0x45, 0x34, 0x32, 0x44, 0x44, 0x23, 0x21, 0x33, 0x33, 0x12,
+    0x00, 0x32, 0x44, 0x44, 0x23, 0x43, 0x55, 0x55, 0x34, 0x54, 0x05, 0x50, 0x45, 0x54, 0x10, 0x01,
+    0x45, 0x54, 0x10, 0x01, 0x45, 0x54, 0x05, 0x50, 0x45, 0x43, 0x55, 0x55, 0x34, 0x32, 0x44, 0x44,
+    0x23, 0x00, 0x43, 0x55, 0x55, 0x34, 0x54, 0x00, 0x00, 0x45, 0x05, 0x10, 0x01, 0x50, 0x05, 0x11,
+    0x11, 0x50, 0x05, 0x11, 0x11, 0x50, 0x05, 0x10, 0x01, 0x50, 0x54, 0x00, 0x00, 0x45, 0x43, 0x55,
+    0x55, 0x34, 0x02, 0x04, 0x05, 0x30, 0x05, 0x04, 0x05, 0x00, 0x31, 0x00, 0x05, 0x00, 0x51, 0x10,
+    0x51, 0x10, 0x51, 0x10, 0x51, 0x00, 0x05, 0x00, 0x31, 0x00, 0x05, 0x04, 0x05, 0x30, 0x05, 0x04,
+    0x02, 0x05, 0x00, 0x31, 0x00, 0x05, 0x00, 0x51, 0x00, 0xa1, 0x12, 0x51, 0x12, 0xa1, 0x00, 0x51,
+    0x00, 0x05, 0x00, 0x31, 0x00, 0x05,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_RIPPLE_8X8_PACKED = {
+    .frames = 8,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_RIPPLE_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_RIPPLE_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_RIPPLE_8X8_PACKED_DATA,
+};
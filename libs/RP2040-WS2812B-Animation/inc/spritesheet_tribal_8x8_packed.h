@@ -0,0 +1,24 @@
+static const uGRB32_t SPRITESHEET_TRIBAL_8X8_PACKED_PALETTE[]={
+    0x00000000, 0x0080ffff, 0x0000ff80, 0x00ffffff, 0x00ffff00,
+};
+
+static const uint16_t SPRITESHEET_TRIBAL_8X8_PACKED_OFFSETS[]={
+    0, 33,
+};
+
+static const uint8_t SPRITESHEET_TRIBAL_8X8_PACKED_DATA[]={
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x21, 0x00, 0x02, 0x20, 0x20, 0x20, 0x21, 0x12, 0x22,
+    0x22, 0x10, 0x32, 0x22, 0x02, 0x00, 0x14, 0x42, 0x00, 0x20, 0x40, 0x04, 0x02, 0x00, 0x01, 0x10,
+    0x00, 0x00, 0x00, 0x21, 0x21, 0x00, 0x02, 0x20, 0x20, 0x20, 0x21, 0x12, 0x22, 0x22, 0x10, 0x32,
+    0x22, 0x02, 0x00, 0x12, 0x22, 0x00, 0x00, 0x44, 0x44, 0x00, 0x00, 0x02, 0x20, 0x00, 0x00, 0x01,
+    0x10, 0x00,
+};
+
+static const ws2812b_sheet_t SPRITESHEET_TRIBAL_8X8_PACKED = {
+    .frames = 2,
+    .pixels = 64,
+    .flags = WS2812B_SHEET_4BIT,
+    .palette = SPRITESHEET_TRIBAL_8X8_PACKED_PALETTE,
+    .offsets = SPRITESHEET_TRIBAL_8X8_PACKED_OFFSETS,
+    .data = SPRITESHEET_TRIBAL_8X8_PACKED_DATA,
+};
@@ -0,0 +1,59 @@
+/**
+ * @file bench_color.c
+ * @brief Host benchmark of the color math: colors per microsecond of
+ * ws2812b_hsv16 against the float ws2812b_hsv, and of ws2812b_scale_color.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "ws2812b_animation.h"
+
+#define COLORS 3000000
+#define ROUNDS 5        // The fastest round is reported
+
+static volatile uint32_t sink;
+
+static double now_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Time one way of making colors.
+ * @param name Function shown in the results
+ * @param color Function returning the i-th color
+ */
+static void bench(const char *name, uGRB32_t (*color)(uint32_t i)) {
+    double best = 0;
+    for(uint32_t r=0; r<ROUNDS; r++) {
+        uint32_t sum = 0;
+        double t = now_us();
+        for(uint32_t i=0; i<COLORS; i++) {
+            sum += color(i);
+        }
+        double rate = COLORS / (now_us() - t);
+        sink = sum;
+        if(rate > best) best = rate;
+    }
+    printf("%-20s %7.1f Mcolors/s\n", name, best);
+}
+
+static uGRB32_t hsv_float(uint32_t i) {
+    return ws2812b_hsv(i % 360, 100.0f, i % 101);
+}
+
+static uGRB32_t hsv_int(uint32_t i) {
+    return ws2812b_hsv16(i * 181, 255, i);
+}
+
+static uGRB32_t scale_color(uint32_t i) {
+    return ws2812b_scale_color(i, i >> 8);
+}
+
+int main() {
+    bench("ws2812b_hsv", hsv_float);
+    bench("ws2812b_hsv16", hsv_int);
+    bench("ws2812b_scale_color", scale_color);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bench_render.c
+ * @brief Host benchmark of the frame conversion: pixels converted per microsecond
+ * by the renderer, and the time to rebuild the channel lookup table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ws2812b_animation.h"
+
+#define PIXELS 1024
+#define ROUNDS 50
+#define FRAMES 100      // Per round, the fastest round is reported
+#define REBUILDS 2000
+
+static double now_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Publish and send frames, timing only the renderer.
+ * The time includes compositing, which is a pointer swap without effects,
+ * and the copy of the frame captured by the host DMA stand-in.
+ * @param name Configuration shown in the results
+ */
+static void bench_frames(const char *name) {
+    double best = 0;
+    for(uint32_t r=0; r<ROUNDS; r++) {
+        double busy = 0;
+        uint32_t first = ws2812b_host_frame_count();
+        for(uint32_t f=0; f<FRAMES; f++) {
+            ws2812b_put(f % PIXELS, rand() & 0xffffff);
+            ws2812b_render();
+            double t = now_us();
+            ws2812b_host_run(20000);
+            busy += now_us() - t;
+        }
+        double rate = (ws2812b_host_frame_count() - first) * (double)PIXELS / busy;
+        if(rate > best) best = rate;
+    }
+    printf("%-28s %7.1f px/us (%u pixels)\n", name, best, PIXELS);
+}
+
+/**
+ * @brief Time the lookup table rebuilt by every brightness change.
+ * @param name Configuration shown in the results
+ */
+static void bench_rebuild(const char *name) {
+    double t = now_us();
+    for(uint32_t i=0; i<REBUILDS; i++) {
+        ws2812b_set_brightness(i & 0xff);
+    }
+    printf("%-28s %7.2f us per table\n", name, (now_us() - t) / REBUILDS);
+}
+
+int main() {
+    ws2812b_init(pio0, 0, PIXELS);
+    for(uint32_t i=0; i<PIXELS; i++) {
+        ws2812b_put(i, rand() & 0xffffff);
+    }
+
+    ws2812b_set_brightness(255);
+    bench_frames("full brightness");
+    ws2812b_set_brightness(64);
+    bench_frames("brightness 64");
+    ws2812b_set_gamma(2.2f);
+    bench_frames("brightness 64, gamma 2.2");
+    ws2812b_set_dithering(true);
+    bench_frames("dithering");
+    ws2812b_set_dithering(false);
+    ws2812b_set_inverted(true);
+    bench_frames("inverted");
+    ws2812b_set_inverted(false);
+    for(uint32_t i=0; i<PIXELS; i+=2) {
+        ws2812b_set_pixel_brightness(i, 32 << (i % 3));
+    }
+    bench_frames("half the pixels dimmed");
+    for(uint32_t i=0; i<PIXELS; i+=2) {
+        ws2812b_set_pixel_brightness(i, 255);
+    }
+    for(uint32_t i=0; i<PIXELS; i+=2) {
+        ws2812b_set_pixel_brightness(i, i & 0xff);
+    }
+    bench_frames("half the pixels, 128 levels");
+    for(uint32_t i=0; i<PIXELS; i+=2) {
+        ws2812b_set_pixel_brightness(i, 255);
+    }
+
+    ws2812b_set_gamma(1.0f);
+    bench_rebuild("table rebuild, linear");
+    ws2812b_set_gamma(2.2f);
+    bench_rebuild("table rebuild, gamma 2.2");
+    return 0;
+}
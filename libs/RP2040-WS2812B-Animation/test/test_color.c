@@ -0,0 +1,91 @@
+/**
+ * @file test_color.c
+ * @brief Host test of the integer color math against the float versions.
+ * ws2812b_hsv16 and ws2812b_scale_color must stay within MAX_ERROR of the
+ * float result on every channel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ws2812b_animation.h"
+
+#define MAX_ERROR 2
+
+static uint32_t failures;
+
+/**
+ * @brief Largest difference between the channels of two colors.
+ * @param a First color
+ * @param b Second color
+ * @return Difference (0-255)
+ */
+static int channel_error(uGRB32_t a, uGRB32_t b) {
+    int worst = 0;
+    for(uint32_t shift=0; shift<24; shift+=8) {
+        int d = abs((int)((a >> shift) & 0xffu) - (int)((b >> shift) & 0xffu));
+        if(d > worst) worst = d;
+    }
+    return worst;
+}
+
+/**
+ * @brief Compare ws2812b_hsv16 with ws2812b_hsv over hue, saturation and value.
+ */
+static void test_hsv16() {
+    int worst = 0;
+    for(uint32_t h=0; h<360; h++) {
+        for(uint32_t s=0; s<=100; s+=5) {
+            for(uint32_t v=0; v<=100; v+=5) {
+                uGRB32_t expected = ws2812b_hsv(h, s, v);
+                uGRB32_t actual = ws2812b_hsv16(h * 65536 / 360, s * 255 / 100, v * 255 / 100);
+                int e = channel_error(expected, actual);
+                if(e > worst) worst = e;
+                if(e > MAX_ERROR) {
+                    printf("hsv16 %u %u %u: %06x, float %06x\n", h, s, v, actual, expected);
+                    failures++;
+                }
+            }
+        }
+    }
+    printf("hsv16: largest channel error %d\n", worst);
+}
+
+/**
+ * @brief Compare ws2812b_scale_color with float scaling, and check the channels stay apart.
+ */
+static void test_scale_color() {
+    int worst = 0;
+    for(uint32_t x=0; x<256; x++) {
+        for(uint32_t scale=0; scale<256; scale++) {
+            // Different levels on each channel, so a carry into a neighbour shows
+            uGRB32_t grb = (x << 16) | ((255 - x) << 8) | (x ^ 0x5a);
+            uGRB32_t expected = 0;
+            for(uint32_t shift=0; shift<24; shift+=8) {
+                uint32_t c = (grb >> shift) & 0xffu;
+                expected |= (uint32_t)(c * scale / 255.0f + 0.5f) << shift;
+            }
+            uGRB32_t actual = ws2812b_scale_color(grb, scale);
+            int e = channel_error(expected, actual);
+            if(e > worst) worst = e;
+            if(e > MAX_ERROR || (actual & 0xff000000u)) {
+                printf("scale_color %06x by %u: %06x, float %06x\n", grb, scale, actual, expected);
+                failures++;
+            }
+        }
+    }
+    if(ws2812b_scale_color(0xffffff, 255) != 0xffffff || ws2812b_scale_color(0xffffff, 0) != 0) {
+        printf("scale_color: 255 must keep the color and 0 turn it off\n");
+        failures++;
+    }
+    printf("scale_color: largest channel error %d\n", worst);
+}
+
+int main() {
+    test_hsv16();
+    test_scale_color();
+    if(failures) {
+        printf("%u failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+import sys
+import os
+import re
+
+# Generate constant time code point to glyph lookup tables
+# from the CHARMAP_CP0_EU array of CP0_EU_8x8.h, for use with
+# RP2040-WS2812B-Animation library.
+
+FALLBACK = 215  # CHARMAP_CP0_EU[215] is a bullet glyph
+
+# Code point ranges looked up through a direct table
+RANGES = [
+    ("LATIN1", 0x0000, 0x0100),     # ASCII and Latin-1
+    ("LATIN_EXT_A", 0x0100, 0x0180),
+    ("GREEK", 0x0380, 0x03d0),
+]
+
+def read_charmap(path):
+    source = open(path, encoding="utf-8").read()
+    body = re.search(r"CHARMAP_CP0_EU\[256\]\s*=\s*\{(.*?)\}", source, re.S).group(1)
+    charmap = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+    if len(charmap) != 256:
+        raise ValueError("expected 256 code points, found %d" % len(charmap))
+    return charmap
+
+def write_table(f, name, base, end, glyphs):
+    f.write("static const uint8_t CP0_EU_%s[%d] = { // U+%04X-U+%04X\n" % (name, end - base, base, end - 1))
+    for row in range(base, end, 16):
+        values = [glyphs.get(cp, FALLBACK) for cp in range(row, min(row + 16, end))]
+        f.write("    " + ", ".join("%3d" % v for v in values) + ",\n")
+    f.write("};\n\n")
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print ("Usage: %s [CP0_EU_8x8.h] [output.h]" % (sys.argv[0],))
+        sys.exit(1)
+
+    charmap = read_charmap(sys.argv[1])
+    glyphs = {}
+    for index, cp in enumerate(charmap):
+        glyphs.setdefault(cp, index)
+
+    others = sorted((cp, g) for cp, g in glyphs.items()
+                    if not any(base <= cp < end for _, base, end in RANGES))
+
+    guard = os.path.splitext(os.path.basename(sys.argv[2]))[0].upper() + "_H"
+    print ("Writing file: %s" % sys.argv[2])
+    f = open(sys.argv[2], "w")
+    f.write("/**\n")
+    f.write(" * @file %s\n" % os.path.basename(sys.argv[2]))
+    f.write(" * @brief Code point to glyph index lookup for the CP0-EU character set.\n")
+    f.write(" * @details Generated by tools/cp0eu2lookup.py from CHARMAP_CP0_EU, do not edit.\n")
+    f.write(" */\n\n")
+    f.write("#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n" % (guard, guard))
+    f.write("#define CP0_EU_FALLBACK_GLYPH %d\n\n" % FALLBACK)
+
+    for name, base, end in RANGES:
+        write_table(f, name, base, end, glyphs)
+
+    f.write("static const struct { uint16_t codepoint; uint8_t glyph; } CP0_EU_OTHERS[%d] = {\n" % len(others))
+    for cp, g in others:
+        f.write("    { 0x%04x, %3d },\n" % (cp, g))
+    f.write("};\n\n")
+
+    f.write("/**\n")
+    f.write(" * @brief Get the glyph index of a code point.\n")
+    f.write(" * @param codepoint Unicode code point.\n")
+    f.write(" * @return Index into CP0_EU_8x8, CP0_EU_FALLBACK_GLYPH if the character set lacks the code point.\n")
+    f.write(" */\n")
+    f.write("static inline uint8_t cp0_eu_glyph(uint32_t codepoint) {\n")
+    for name, base, end in RANGES:
+        if base == 0:
+            f.write("    if (codepoint < 0x%04x) return CP0_EU_%s[codepoint];\n" % (end, name))
+        else:
+            f.write("    if (codepoint >= 0x%04x && codepoint < 0x%04x) return CP0_EU_%s[codepoint - 0x%04x];\n" % (base, end, name, base))
+    f.write("    uint32_t lo = 0, hi = %d;\n" % len(others))
+    f.write("    while (lo < hi) {\n")
+    f.write("        uint32_t mid = (lo + hi) / 2;\n")
+    f.write("        if (CP0_EU_OTHERS[mid].codepoint < codepoint) lo = mid + 1;\n")
+    f.write("        else hi = mid;\n")
+    f.write("    }\n")
+    f.write("    return (lo < %d && CP0_EU_OTHERS[lo].codepoint == codepoint) ? CP0_EU_OTHERS[lo].glyph : CP0_EU_FALLBACK_GLYPH;\n" % len(others))
+    f.write("}\n\n")
+    f.write("#endif\n")
+    f.close()
@@ -2,16 +2,141 @@
 
 import sys
 import os
-from PIL import Image
+import re
 
 # Convert images to uRGB32_t arrays for use with
 # RP2040-WS2812B-Animation library.
+#
+# With -s, a sequence of frames is packed into a palette-indexed
+# spritesheet (ws2812b_sheet_t) instead, see ws2812b_spritesheet_packed.
+# Frames are images, or headers written by this script whose arrays
+# are taken as frames in order.
+
+FRAME_DELTA = 0x01  # Pixels with the KEEP index keep the previous frame
+FRAME_RLE = 0x02    # Indices are stored as runs
+SHEET_4BIT = 0x01   # Two indices per byte, low nibble first
+
+def load_frames(path):
+    if path.endswith(".h"):
+        source = open(path).read()
+        arrays = re.findall(r"uGRB32_t\s+\w+\[\]\s*=\s*\{(.*?)\}", source, re.S)
+        return [[int(v, 16) & 0xffffff for v in re.findall(r"0x[0-9a-fA-F]+", a)] for a in arrays]
+
+    from PIL import Image
+    image = Image.open(path).convert("RGBA")
+    bitmap = image.load()
+    frame = []
+    for y in range(0, image.size[1]):
+        for x in range(0, image.size[0]):
+            r, g, b, a = bitmap[x, y]
+            frame.append((g << 16) | (r << 8) | b)
+    return [frame]
+
+def encode(indices, four_bit):
+    data = []
+    if four_bit:
+        for i in range(0, len(indices), 2):
+            high = indices[i + 1] if i + 1 < len(indices) else 0
+            data.append(indices[i] | (high << 4))
+    else:
+        data = list(indices)
+    return data
+
+def encode_rle(indices, four_bit):
+    data = []
+    longest = 16 if four_bit else 256
+    i = 0
+    while i < len(indices):
+        run = 1
+        while i + run < len(indices) and run < longest and indices[i + run] == indices[i]:
+            run += 1
+        if four_bit:
+            data.append(((run - 1) << 4) | indices[i])
+        else:
+            data += [run - 1, indices[i]]
+        i += run
+    return data
+
+def pack(frames, rle, delta):
+    palette = []
+    for frame in frames:
+        for grb in frame:
+            if grb not in palette:
+                palette.append(grb)
+    four_bit = len(palette) < 16
+    keep = 0x0f if four_bit else 0xff
+    if len(palette) > keep:
+        raise ValueError("%d colors, at most 255 fit in a sheet" % len(palette))
+
+    data = []
+    offsets = []
+    previous = None
+    for frame in frames:
+        indices = [palette.index(grb) for grb in frame]
+        candidates = [[0] + encode(indices, four_bit)]
+        if rle:
+            candidates.append([FRAME_RLE] + encode_rle(indices, four_bit))
+        # The first frame is a keyframe, so the sheet can loop back to it
+        if delta and previous is not None:
+            changes = [keep if i == p else i for i, p in zip(indices, previous)]
+            candidates.append([FRAME_DELTA] + encode(changes, four_bit))
+            if rle:
+                candidates.append([FRAME_DELTA | FRAME_RLE] + encode_rle(changes, four_bit))
+        offsets.append(len(data))
+        data += min(candidates, key=len)
+        previous = indices
+    return palette, (SHEET_4BIT if four_bit else 0), offsets, data
+
+def write_sheet(name, frames, rle, delta):
+    pixels = len(frames[0])
+    if any(len(frame) != pixels for frame in frames):
+        raise ValueError("all frames must have the same size")
+    palette, flags, offsets, data = pack(frames, rle, delta)
+
+    print ("Packing %d frames: %s.h, %d bytes instead of %d" %
+           (len(frames), name, 4 * len(palette) + 2 * len(offsets) + len(data), 4 * pixels * len(frames)))
+    f = open(name + ".h", "w+")
+    f.write("static const uGRB32_t %s_PALETTE[]={\n    " % name.upper())
+    f.write(", ".join("0x%08x" % grb for grb in palette))
+    f.write(",\n};\n\n")
+    f.write("static const uint16_t %s_OFFSETS[]={\n    " % name.upper())
+    f.write(", ".join("%d" % o for o in offsets))
+    f.write(",\n};\n\n")
+    f.write("static const uint8_t %s_DATA[]={\n" % name.upper())
+    for row in range(0, len(data), 16):
+        f.write("    " + ", ".join("0x%02x" % b for b in data[row:row + 16]) + ",\n")
+    f.write("};\n\n")
+    f.write("static const ws2812b_sheet_t %s = {\n" % name.upper())
+    f.write("    .frames = %d,\n" % len(frames))
+    f.write("    .pixels = %d,\n" % pixels)
+    f.write("    .flags = %s,\n" % ("WS2812B_SHEET_4BIT" if flags & SHEET_4BIT else "0"))
+    f.write("    .palette = %s_PALETTE,\n" % name.upper())
+    f.write("    .offsets = %s_OFFSETS,\n" % name.upper())
+    f.write("    .data = %s_DATA,\n" % name.upper())
+    f.write("};\n")
+    f.close()
 
 if __name__ == "__main__":
+    args = sys.argv[1:]
+    if args and args[0] == "-s":
+        rle = "-r" in args
+        delta = "-d" in args
+        args = [a for a in args[1:] if a not in ("-r", "-d")]
+        if len(args) < 2:
+            print ("Usage: %s -s [-r] [-d] [name] [frames...]" % (sys.argv[0],))
+            sys.exit(1)
+        frames = []
+        for path in args[1:]:
+            frames += load_frames(path)
+        write_sheet(args[0], frames, rle, delta)
+        sys.exit(0)
+
     if len(sys.argv) != 2:
         print ("Usage: %s [image]" % (sys.argv[0],))
+        print ("       %s -s [-r] [-d] [name] [frames...]" % (sys.argv[0],))
         sys.exit(1)
 
+    from PIL import Image
     image = Image.open(sys.argv[1])
     bitmap = image.load()
 
@@ -31,4 +156,4 @@ if __name__ == "__main__":
         f.write("\n")
 
     f.write("};\n")
-    f.close()
\ No newline at end of file
+    f.close()
@@ -7,62 +7,99 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#ifndef WS2812B_HOST
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#endif
 #include "ws2812b_animation.h"
-#include "ws2812.pio.h"
 #include "CP0_EU_8x8.h" // https://github.com/TuriSc/CP0-EU
+#include "CP0_EU_lookup.h" // Generated by tools/cp0eu2lookup.py
 #include "utf-8.h"      // https://github.com/adrianwk94/utf8-iterator
 
 /**
- * @brief UTF-8 iterator for text rendering.
+ * @brief Buffer to store pixel data, drawn by the application (back buffer).
  */
-static utf8_iter ITER;
+static uGRB32_t *ws2812b_buffer;
 
 /**
- * @brief Buffer to store pixel data.
+ * @brief Last frame published with ws2812b_render, not taken by the renderer yet.
  */
-static uGRB32_t *ws2812b_buffer;
+static uGRB32_t *ready_buffer;
 
 /**
- * @brief Text effect structure.
+ * @brief Frame taken by the renderer, composited with the effects (front buffer).
  */
-static FX_t FX_text;
+static uGRB32_t *front_buffer;
 
 /**
- * @brief Array of effect structures.
+ * @brief Flag set when ready_buffer holds a frame newer than front_buffer.
  */
-static FX_t fxs[MAX_EFFECTS];
+static bool frame_published;
 
 /**
- * @brief Timer ID for frame-by-frame rendering.
+ * @brief Hardware spinlock guarding the swaps of the frame buffers.
  */
-static alarm_id_t frame_by_frame_timer;
+static spin_lock_t *frame_lock;
 
 /**
- * @brief Timer ID for rendering.
+ * @brief Pixels left by stopped effects, handed to the back buffer by the application.
+ * The top byte is HANDOFF_PENDING until the pixel is written into the back
+ * buffer, HANDOFF_APPLIED until that buffer is published, 0 for the others.
+ * Guarded by frame_lock.
  */
-static repeating_timer_t rendering_timer;
+static uGRB32_t *handoff_buffer;
+
+#define HANDOFF_PENDING 0xff000000u
+#define HANDOFF_APPLIED 0x01000000u
 
 /**
- * @brief Array of timer IDs for animation effects.
+ * @brief Flag set while handoff_buffer holds pixels not written into the back buffer.
  */
-static alarm_id_t animation_timers[MAX_EFFECTS];
+static volatile bool handoff_pending;
 
 /**
- * @brief Flag to request rendering.
+ * @brief Flag set while handoff_buffer holds pixels not published yet.
  */
-static bool request_render;
+static bool handoff_active;
 
 /**
- * @brief Character being rendered.
+ * @brief Base frame and effect layers composited into one frame.
  */
-static const char* Character;
+static uGRB32_t *frame_buffer;
 
 /**
- * @brief Double buffer for text rendering.
+ * @brief Pool of effect structures, allocated at init.
  */
-static int double_buffer[8][16];
+static FX_t *fx_pool;
+
+/**
+ * @brief Number of effects in the pool.
+ */
+static uint16_t fx_pool_size;
+
+/**
+ * @brief Alarm ID of the frame clock stepping the effects, 0 while idle.
+ */
+static alarm_id_t frame_clock;
+
+/**
+ * @brief Flag set while a render alarm is pending.
+ */
+static volatile bool render_scheduled;
+
+/**
+ * @brief Time the last frame was sent, in microseconds.
+ */
+static uint64_t last_frame_us;
+
+/**
+ * @brief Flag to request rendering.
+ */
+static volatile bool request_render;
 
 /**
  * @brief Configuration structure for WS2812B LED strip.
@@ -75,14 +112,116 @@ static struct ws2812b_config config;
 static uint8_t *no_mask;
 
 /**
- * @brief Get an available segment for an effect.
- * @return Available segment index.
+ * @brief Frame converted to PIO words, read by the DMA channel.
+ */
+static uint32_t *staging_buffer;
+
+/**
+ * @brief DMA channel feeding the PIO TX FIFO.
+ */
+static int dma_chan;
+
+/**
+ * @brief Bit-planes of the strips in parallel mode, 24 bytes per pixel,
+ * read by the DMA channel instead of the staging buffer.
+ */
+static uint32_t *plane_buffer;
+
+/**
+ * @brief Number of 32-bit words sent per pixel (per pixel of each strip in parallel mode).
  */
-static uint8_t get_available_segment() {
-    for (uint8_t i = 0; i < MAX_EFFECTS; i++) {
-        if (!fxs[i].running) { return i; }
+static uint8_t words_per_pixel;
+
+/**
+ * @brief Flag set while a frame is being sent or latched.
+ */
+static volatile bool transfer_busy;
+
+/**
+ * @brief Channel lookup tables with inversion, gamma and brightness applied.
+ * Entries are 8.8 fixed point, the fraction is kept by dithering. Table 0
+ * is for pixels at full per-pixel brightness, the others are table 0 scaled
+ * by a per-pixel level, so the renderer does not multiply for the levels that
+ * have a table.
+ */
+static uint16_t lut[WS2812B_PIXEL_LEVELS + 1][256];
+
+/**
+ * @brief The channel lookup tables rounded to 8 bits, used when not dithering.
+ */
+static uint8_t lut8[WS2812B_PIXEL_LEVELS + 1][256];
+
+/**
+ * @brief Per-pixel brightness level of each table, table 0 is always 255.
+ */
+static uint8_t level_brightness[WS2812B_PIXEL_LEVELS + 1];
+
+/**
+ * @def LEVEL_SCALED
+ * @brief Table slot of the pixels whose level got no table, scaled by a multiply.
+ */
+#define LEVEL_SCALED (WS2812B_PIXEL_LEVELS + 1)
+
+/**
+ * @brief Number of pixels using each table, a table is free when it has none.
+ * The last entry counts the pixels at LEVEL_SCALED.
+ */
+static uint16_t level_pixels[LEVEL_SCALED + 1];
+
+/**
+ * @brief Lookup table of each pixel, or LEVEL_SCALED.
+ */
+static uint8_t *pixel_level;
+
+/**
+ * @brief Brightness of each pixel at LEVEL_SCALED, as a scale (1-256).
+ */
+static uint16_t *pixel_scale;
+
+/**
+ * @brief Fraction left over from the last frame, three channels per pixel.
+ */
+static uint8_t *dither_error;
+
+/**
+ * @brief Flag set when the last frame left a fraction to dither out.
+ */
+static volatile bool dither_pending;
+
+/**
+ * @brief Estimated current of the frames, updated on each render.
+ */
+static struct ws2812b_power_stats power_stats;
+
+/**
+ * @brief Flag set when the estimate of the last frame is left to ws2812b_get_power_stats.
+ */
+static volatile bool power_stats_stale;
+
+/**
+ * @brief Pixel index of every point of the matrix, row by row, built by ws2812b_matrix_init.
+ */
+static uint16_t *matrix_map;
+
+static void schedule_render();
+
+/**
+ * @brief Get an effect from the pool.
+ * The layer of the effect is cleared and its blending reset.
+ * @return Free effect, NULL if all the effects in the pool are running.
+ */
+static FX_t* get_available_effect() {
+    for (uint16_t i = 0; i < fx_pool_size; i++) {
+        FX_t *FX = &fx_pool[i];
+        if (!FX->running) {
+            memset(FX->layer, 0, config.num_pixels * sizeof(uGRB32_t));
+            FX->blend = FX_BLEND_REPLACE;
+            FX->opacity = 255;
+            FX->canceled = false;
+            return FX;
+        }
     }
-    return MAX_EFFECTS - 1; // Fallback
+    return NULL;
 }
 
 /**
@@ -160,6 +299,42 @@ uGRB32_t ws2812b_hsv(float _h, float _s, float _v) {
     return ((uint32_t)(r * 255) << 8) | ((uint32_t)(g * 255) << 16) | (uint32_t)(b * 255);
 }
 
+/**
+ * @brief Create a 24-bit color from HSV values, in integer math.
+ * @param h Hue (0-65535 for a full turn).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @return 24-bit color value.
+ */
+uGRB32_t ws2812b_hsv16(uint16_t h, uint8_t s, uint8_t v) {
+    uint32_t h6 = (uint32_t)h * 6;
+    uint8_t sector = h6 >> 16;
+    uint8_t f = (h6 >> 8) & 0xffu; // Position inside the sector
+    uint8_t p = ws2812b_scale8(v, 255 - s);
+    uint8_t q = ws2812b_scale8(v, 255 - ws2812b_scale8(s, f));
+    uint8_t t = ws2812b_scale8(v, 255 - ws2812b_scale8(s, 255 - f));
+
+    switch (sector) {
+        case 0:  return ws2812b_rgb(v, t, p);
+        case 1:  return ws2812b_rgb(q, v, p);
+        case 2:  return ws2812b_rgb(p, v, t);
+        case 3:  return ws2812b_rgb(p, q, v);
+        case 4:  return ws2812b_rgb(t, p, v);
+        default: return ws2812b_rgb(v, p, q);
+    }
+}
+
+/**
+ * @brief Create a 24-bit color from 8-bit HSV values, in integer math.
+ * @param h Hue (0-255 for a full turn).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @return 24-bit color value.
+ */
+uGRB32_t ws2812b_hsv8(uint8_t h, uint8_t s, uint8_t v) {
+    return ws2812b_hsv16((uint16_t)h << 8, s, v);
+}
+
 /**
  * @brief Create a random 24-bit color.
  * @param value Value (0.0-100.0).
@@ -167,8 +342,8 @@ uGRB32_t ws2812b_hsv(float _h, float _s, float _v) {
  */
 uGRB32_t ws2812b_random_color(float value) {
     init_random();
-    float h = (rand() % 360);
-    return ws2812b_hsv(h, 100.0f, value);
+    uint8_t v = (value >= 100.0f ? 255 : (value <= 0.0f ? 0 : (uint8_t)(value * 2.55f)));
+    return ws2812b_hsv16(rand() & 0xffff, 255, v);
 }
 
 /**
@@ -176,61 +351,429 @@ uGRB32_t ws2812b_random_color(float value) {
  */
 
 /**
- * @brief Write a pixel to the LED strip in blocking mode.
- * @param pixel_grb 24-bit color value.
+ * @brief Map a brightness level to a scale factor.
+ * @param level Brightness (0-255).
+ * @return Scale (0-256), so that full brightness is exact.
  */
-static inline void ws2812b_write_blocking(uGRB32_t pixel_grb) {
-    pio_sm_put_blocking(config.pio, config.pio_sm, pixel_grb << 8u);
+static inline uint16_t brightness_scale(uint8_t level) {
+    return (level ? level + 1 : 0);
+}
+
+/**
+ * @brief Build the lookup table of a per-pixel brightness level from table 0.
+ * @param slot Table to build (1 to WS2812B_PIXEL_LEVELS)
+ */
+static void build_level_lut(uint32_t slot) {
+    uint32_t scale = brightness_scale(level_brightness[slot]);
+    for (uint32_t i = 0; i < 256; i++) {
+        lut[slot][i] = (lut[0][i] * scale) >> 8u;
+        lut8[slot][i] = (lut[slot][i] + 0x80u) >> 8u;
+    }
+}
+
+/**
+ * @brief Rebuild the channel lookup tables from the current configuration.
+ * Called when inversion, gamma or brightness change, never per frame.
+ * Only the tables of the per-pixel levels in use are rebuilt.
+ */
+static void build_luts() {
+    uint32_t scale = brightness_scale(config.brightness);
+    for (uint32_t i = 0; i < 256; i++) {
+        uint8_t v = (config.inverted ? 255 - i : i);
+        uint32_t v16 = (uint32_t)v << 8u;
+        if (config.gamma != 1.0f) {
+            v16 = (uint32_t)(powf(v / 255.0f, config.gamma) * 65280.0f + 0.5f);
+        }
+        lut[0][i] = (v16 * scale) >> 8u;
+        lut8[0][i] = (lut[0][i] + 0x80u) >> 8u;
+    }
+    for (uint32_t slot = 1; slot <= WS2812B_PIXEL_LEVELS; slot++) {
+        if (level_pixels[slot]) build_level_lut(slot);
+    }
+}
+
+/**
+ * @brief End of the reset latch, the next frame may be sent.
+ * @param id Alarm ID
+ * @param user_data Unused
+ * @return 0, the alarm does not repeat
+ */
+static int64_t latch_done(alarm_id_t id, void *user_data) {
+    transfer_busy = false;
+    // Requested while sending, or the dithering has not caught up yet
+    if(request_render || dither_pending) {
+        request_render = true;
+        schedule_render();
+    }
+    return 0;
+}
+
+/**
+ * @brief DMA completion handler.
+ * When the last word has been read the FIFO and the shift register still hold
+ * pixels, so the latch alarm waits for them to shift out before the reset time.
+ */
+static void dma_complete() {
+    if(!dma_channel_get_irq0_status(dma_chan)) return;
+    dma_channel_acknowledge_irq0(dma_chan);
+
+    uint32_t pending = pio_sm_get_tx_fifo_level(config.pio, config.pio_sm) + 1;
+    uint32_t pending_us = (pending * WS2812B_PIXEL_US + words_per_pixel - 1) / words_per_pixel;
+    if(add_alarm_in_us(pending_us + WS2812B_DELAY_US, latch_done, NULL, true) < 0) {
+        transfer_busy = false; // No alarm slot left
+    }
+}
+
+/**
+ * @brief Blend a pixel of a layer into a pixel of a frame.
+ * @param d Pixel of the frame
+ * @param s Pixel of the layer, without its alpha
+ * @param blend Blend mode of the effect
+ * @param a Alpha of the pixel scaled by the opacity of the effect, above 0
+ * @return Blended pixel
+ */
+static inline uGRB32_t blend_pixel(uGRB32_t d, uGRB32_t s, FX_blend_t blend, uint32_t a) {
+    switch (blend) {
+        case FX_BLEND_REPLACE:
+            return s;
+        case FX_BLEND_ADD: {
+            uint32_t sum = 0;
+            for (uint32_t shift = 0; shift < 24; shift += 8) {
+                uint32_t c = ((d >> shift) & 0xffu) + ((((s >> shift) & 0xffu) * (a + 1)) >> 8u);
+                sum |= (c > 255 ? 255 : c) << shift;
+            }
+            return sum;
+        }
+        case FX_BLEND_ALPHA: {
+            uint32_t mix = 0;
+            for (uint32_t shift = 0; shift < 24; shift += 8) {
+                int32_t dc = (d >> shift) & 0xffu;
+                int32_t sc = (s >> shift) & 0xffu;
+                mix |= (uint32_t)(dc + (((sc - dc) * (int32_t)(a + 1)) >> 8)) << shift;
+            }
+            return mix;
+        }
+    }
+    return d;
+}
+
+/**
+ * @brief Blend a layer into a frame.
+ * @param dst Frame to blend into
+ * @param FX Effect owning the layer
+ */
+static void blend_layer(uGRB32_t *dst, const FX_t *FX) {
+    const uGRB32_t *src = FX->layer;
+    uint32_t opacity = FX->opacity + 1;
+    for (uint32_t i = 0; i < config.num_pixels; i++) {
+        uint32_t a = ((src[i] >> 24u) * opacity) >> 8u;
+        if (!a) continue; // Transparent, never written by the effect
+        dst[i] = blend_pixel(dst[i], src[i] & 0xffffffu, FX->blend, a);
+    }
+}
+
+/**
+ * @brief Take the last published frame as the front buffer.
+ * Only the buffer pointers are swapped under the lock, so interrupts are
+ * disabled for a few instructions whatever the size of the strip. While
+ * stopped effects have pixels not published yet, they are laid over the
+ * front buffer into the frame buffer.
+ * @return Base frame to composite the effects over.
+ */
+static const uGRB32_t* take_frame() {
+    const uGRB32_t *frame;
+    uint32_t irq_state = spin_lock_blocking(frame_lock);
+    if(frame_published) {
+        uGRB32_t *t = front_buffer;
+        front_buffer = ready_buffer;
+        ready_buffer = t;
+        frame_published = false;
+    }
+    frame = front_buffer;
+    if(handoff_active) {
+        for(uint32_t i=0; i<config.num_pixels; i++) {
+            uGRB32_t h = handoff_buffer[i];
+            frame_buffer[i] = h ? h & 0xffffffu : front_buffer[i];
+        }
+        frame = frame_buffer;
+    }
+    spin_unlock(frame_lock, irq_state);
+    return frame;
+}
+
+/**
+ * @brief Composite the running effects over the base frame.
+ * Layers are blended in pool order.
+ * @return Frame to send.
+ */
+static const uGRB32_t* compose() {
+    const uGRB32_t *frame = take_frame();
+    for (uint16_t i = 0; i < fx_pool_size; i++) {
+        if (!fx_pool[i].running) continue;
+        if (frame != frame_buffer) {
+            memcpy(frame_buffer, frame, config.num_pixels * sizeof(uGRB32_t));
+            frame = frame_buffer;
+        }
+        blend_layer(frame_buffer, &fx_pool[i]);
+    }
+    return frame;
+}
+
+/**
+ * @brief Estimate the current of the staging buffer and scale it down to the budget.
+ * All the pixels are scaled by the same factor, so the colors and the balance
+ * between the pixels are kept.
+ * @param channel_sum Sum of the channel levels of the frame
+ */
+static void limit_power(uint32_t channel_sum) {
+    uint32_t idle_ma = config.num_pixels * WS2812B_IDLE_MA;
+    uint32_t led_ma = (channel_sum * WS2812B_CHANNEL_MA + 254) / 255;
+    power_stats.requested_ma = idle_ma + led_ma;
+    power_stats.frame_ma = power_stats.requested_ma;
+    power_stats_stale = false;
+    if(!config.power_budget_ma || power_stats.requested_ma <= config.power_budget_ma) return;
+
+    uint32_t available = config.power_budget_ma > idle_ma ? config.power_budget_ma - idle_ma : 0;
+    uint32_t scale = (available << 8u) / led_ma; // Below 256, as led_ma > available
+    for(uint32_t i=0; i<config.num_pixels; i++) {
+        uint32_t w = staging_buffer[i];
+        if(!w) continue;
+        uint32_t g = ((w >> 24u) * scale) >> 8u;
+        uint32_t r = (((w >> 16u) & 0xffu) * scale) >> 8u;
+        uint32_t b = (((w >> 8u) & 0xffu) * scale) >> 8u;
+        staging_buffer[i] = (g << 24u) | (r << 16u) | (b << 8u);
+    }
+    power_stats.frame_ma = idle_ma + ((led_ma * scale) >> 8u);
+    power_stats.limited_frames++;
+}
+
+/**
+ * @brief Transpose one byte of eight strips into eight bit-planes.
+ * Plane k holds bit 7-k of every strip, strip s in bit s, so the planes are
+ * in the order the PIO program shifts them out.
+ * @param rows Byte of each strip
+ * @param planes Output, 8 bytes
+ */
+static inline void transpose8(const uint8_t rows[8], uint8_t *planes) {
+    // 8x8 bit matrix transpose in three swap steps, with strip 7 in the top row
+    uint32_t x = ((uint32_t)rows[7] << 24u) | ((uint32_t)rows[6] << 16u) | ((uint32_t)rows[5] << 8u) | rows[4];
+    uint32_t y = ((uint32_t)rows[3] << 24u) | ((uint32_t)rows[2] << 16u) | ((uint32_t)rows[1] << 8u) | rows[0];
+    uint32_t t;
+    t = (x ^ (x >> 7u)) & 0x00aa00aau; x = x ^ t ^ (t << 7u);
+    t = (y ^ (y >> 7u)) & 0x00aa00aau; y = y ^ t ^ (t << 7u);
+    t = (x ^ (x >> 14u)) & 0x0000ccccu; x = x ^ t ^ (t << 14u);
+    t = (y ^ (y >> 14u)) & 0x0000ccccu; y = y ^ t ^ (t << 14u);
+    t = (x & 0xf0f0f0f0u) | ((y >> 4u) & 0x0f0f0f0fu);
+    y = ((x << 4u) & 0xf0f0f0f0u) | (y & 0x0f0f0f0fu);
+    x = t;
+    planes[0] = x >> 24u; planes[1] = x >> 16u; planes[2] = x >> 8u; planes[3] = x;
+    planes[4] = y >> 24u; planes[5] = y >> 16u; planes[6] = y >> 8u; planes[7] = y;
+}
+
+/**
+ * @brief Turn the staging buffer into the bit-planes of the parallel strips.
+ * Every pixel of a strip becomes 24 bytes, one per bit from the msb of green
+ * to the lsb of blue, each carrying that bit of all the strips.
+ */
+static void build_planes() {
+    uint8_t *planes = (uint8_t *)plane_buffer;
+    uint8_t rows[8];
+    for(uint32_t i=0; i<config.strip_pixels; i++) {
+        for(uint32_t shift=24; shift>=8; shift-=8) {
+            for(uint32_t s=0; s<WS2812B_MAX_STRIPS; s++) {
+                rows[s] = s < config.num_strips ? staging_buffer[s * config.strip_pixels + i] >> shift : 0;
+            }
+            transpose8(rows, planes);
+            planes += 8;
+        }
+    }
+}
+
+/**
+ * @brief Convert a frame at full per-pixel brightness without mask, dithering or power limit.
+ * The common case: one table lookup per channel and nothing else, the current
+ * estimate is left to ws2812b_get_power_stats.
+ * @param frame Frame to convert into the staging buffer
+ */
+static void convert_plain(const uGRB32_t *frame) {
+    const uint8_t *t = lut8[0];
+    uint32_t *out = staging_buffer;
+    uint32_t n = config.num_pixels;
+    for(uint32_t i=0; i<n; i++) {
+        uGRB32_t p = frame[i];
+        // GRB in the upper 24 bits of the word shifted out by the PIO program
+        out[i] = ((uint32_t)t[(p >> 16u) & 0xffu] << 24u) | ((uint32_t)t[(p >> 8u) & 0xffu] << 16u) | ((uint32_t)t[p & 0xffu] << 8u);
+    }
+    power_stats_stale = true;
+}
+
+/**
+ * @brief Convert a frame with the per-pixel tables and the mask, rounding to 8 bits.
+ * @param frame Frame to convert into the staging buffer
+ * @return Sum of the channel levels of the frame
+ */
+static uint32_t convert_rounded(const uGRB32_t *frame) {
+    const uint8_t *mask = config.global_mask;
+    uint32_t *out = staging_buffer;
+    uint32_t n = config.num_pixels;
+    uint32_t channel_sum = 0;
+    for(uint32_t i=0; i<n; i++) {
+        uGRB32_t p = frame[i];
+        uint32_t level = pixel_level[i];
+        uint32_t g, r, b;
+        if(level != LEVEL_SCALED) {
+            const uint8_t *t = lut8[level];
+            g = t[(p >> 16u) & 0xffu];
+            r = t[(p >> 8u) & 0xffu];
+            b = t[p & 0xffu];
+        } else {
+            // Level without a table, as its table would be built
+            uint32_t scale = pixel_scale[i];
+            g = (((lut[0][(p >> 16u) & 0xffu] * scale) >> 8u) + 0x80u) >> 8u;
+            r = (((lut[0][(p >> 8u) & 0xffu] * scale) >> 8u) + 0x80u) >> 8u;
+            b = (((lut[0][p & 0xffu] * scale) >> 8u) + 0x80u) >> 8u;
+        }
+        uint32_t m = mask[i];
+        out[i] = ((g << 24u) | (r << 16u) | (b << 8u)) * m;
+        channel_sum += (g + r + b) * m;
+    }
+    return channel_sum;
+}
+
+/**
+ * @brief Convert a frame with the per-pixel tables and the mask, dithering.
+ * The fraction of every channel is carried over to the next frame.
+ * @param frame Frame to convert into the staging buffer
+ * @return Sum of the channel levels of the frame
+ */
+static uint32_t convert_dithered(const uGRB32_t *frame) {
+    const uint8_t *mask = config.global_mask;
+    uint32_t *out = staging_buffer;
+    uint8_t *e = dither_error;
+    uint32_t n = config.num_pixels;
+    uint32_t residual = 0;
+    uint32_t channel_sum = 0;
+    for(uint32_t i=0; i<n; i++, e+=3) {
+        uGRB32_t p = frame[i];
+        uint32_t level = pixel_level[i];
+        uint32_t g, r, b;
+        if(level != LEVEL_SCALED) {
+            const uint16_t *t = lut[level];
+            g = t[(p >> 16u) & 0xffu];
+            r = t[(p >> 8u) & 0xffu];
+            b = t[p & 0xffu];
+        } else {
+            uint32_t scale = pixel_scale[i];
+            g = (lut[0][(p >> 16u) & 0xffu] * scale) >> 8u;
+            r = (lut[0][(p >> 8u) & 0xffu] * scale) >> 8u;
+            b = (lut[0][p & 0xffu] * scale) >> 8u;
+        }
+        g += e[0];
+        r += e[1];
+        b += e[2];
+        e[0] = g;
+        e[1] = r;
+        e[2] = b;
+        residual |= g | r | b;
+        g >>= 8u;
+        r >>= 8u;
+        b >>= 8u;
+        uint32_t m = mask[i];
+        out[i] = ((g << 24u) | (r << 16u) | (b << 8u)) * m;
+        channel_sum += (g + r + b) * m;
+    }
+    dither_pending = (residual & 0xffu) != 0;
+    return channel_sum;
 }
 
 /**
  * @brief Render the LED strip.
- * @return True if rendering was successful, false otherwise.
+ * Composites the effects, converts the frame into the staging buffer and starts the DMA transfer to
+ * the PIO. Inversion, gamma, global and per-pixel brightness are folded into
+ * the tables, so the frame is converted in a single pass, by the simplest
+ * converter the configuration allows. A frame requested while the previous
+ * one is still being sent is scheduled again when its latch time is over.
+ * @param id Alarm ID
+ * @param user_data Unused
+ * @return 0, the alarm does not repeat
  */
-static bool render() {
-    if(request_render) {
+static int64_t render(alarm_id_t id, void *user_data) {
+    render_scheduled = false;
+    if(request_render && !transfer_busy) {
         request_render = false;
-        for(uint32_t i=0; i<config.num_pixels; i++) {
-            uGRB32_t p = ws2812b_buffer[i];
-            uint8_t g = ((p >> 16u) & 0xffu);
-            uint8_t r = ((p >> 8u) & 0xffu);
-            uint8_t b = (p & 0xffu);
-            // Invert colors
-            if(config.inverted) {
-            g = 255 - g;
-            r = 255 - r;
-            b = 255 - b;
+        const uGRB32_t *frame = compose();
+        if(config.dithering) {
+            limit_power(convert_dithered(frame));
+        } else {
+            dither_pending = false;
+            if(!config.power_budget_ma && level_pixels[0] == config.num_pixels && config.global_mask == no_mask) {
+                convert_plain(frame);
+            } else {
+                limit_power(convert_rounded(frame));
             }
-            // Apply global dimming
-            g >>= config.global_dimming;
-            r >>= config.global_dimming;
-            b >>= config.global_dimming;
-            p = ws2812b_rgb(r, g, b);
-            // Apply mask
-            p *= config.global_mask[i];//mask(p, i, config.global_mask);
-            ws2812b_write_blocking(p);
+        }
+        transfer_busy = true;
+        last_frame_us = time_us_64();
+        if(plane_buffer) {
+            build_planes();
+            dma_channel_transfer_from_buffer_now(dma_chan, plane_buffer, config.strip_pixels * words_per_pixel);
+        } else {
+            dma_channel_transfer_from_buffer_now(dma_chan, staging_buffer, config.num_pixels);
         }
     }
+    return 0;
 }
 
 /**
- * @brief Initialize the state machine.
- * @param pio PIO instance.
- * @param gpio GPIO pin.
- * @param num_pixels Number of pixels in the LED strip.
+ * @brief Arm a one-shot alarm for the next frame.
+ * The alarm fires no earlier than config.frame_interval_us after the last
+ * frame. Nothing is armed while a frame is pending or being sent, so without
+ * requests the library does not wake the CPU at all.
  */
-void ws2812b_init(PIO _pio, uint8_t gpio, uint16_t _num_pixels) {
+static void schedule_render() {
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool arm = !render_scheduled && !transfer_busy;
+    if(arm) render_scheduled = true;
+    restore_interrupts(irq_state);
+    if(!arm) return;
+
+    uint64_t now = time_us_64();
+    uint64_t due = last_frame_us + config.frame_interval_us;
+    if(add_alarm_in_us(due > now ? due - now : 0, render, NULL, true) < 0) {
+        render_scheduled = false; // No alarm slot left, retried on the next request
+    }
+}
+
+/**
+ * @brief Allocate the buffers and set up the DMA channel feeding the state machine.
+ * @param _num_pixels Number of pixels in the buffer.
+ * @param max_effects Number of effects that can run at the same time.
+ * @param dma_words Number of words sent per frame.
+ */
+static void setup(uint16_t _num_pixels, uint16_t max_effects, uint32_t dma_words) {
     config.animation_step_ms = 20; // 20ms = 50fps animations
+    config.frame_interval_us = 5000; // 5ms = 200fps at most
+    config.gamma = 1.0f; // Linear, see ws2812b_set_gamma
+    config.brightness = 255;
+    memset(level_pixels, 0, sizeof(level_pixels));
+    build_luts();
     config.num_pixels = _num_pixels;
-    config.pio = _pio;
-    config.pio_sm = pio_claim_unused_sm(_pio, true);
-    uint offset = pio_add_program(_pio, &ws2812_program);
-    ws2812_program_init(_pio, config.pio_sm, offset, gpio, WS2812B_FREQ_HZ, WS2812B_IS_RGBW);
-    
-    // Allocate memory to store pixel data
-    ws2812b_buffer = malloc(_num_pixels * sizeof(ws2812b_buffer));
-    for (uint32_t i = 0; i < _num_pixels; i++) {
-        ws2812b_buffer[i] = 0;
+
+    // Allocate memory to store pixel data: the application draws into the back
+    // buffer and publishes it, the renderer takes the published frame
+    ws2812b_buffer = calloc(_num_pixels, sizeof(uGRB32_t));
+    ready_buffer = calloc(_num_pixels, sizeof(uGRB32_t));
+    front_buffer = calloc(_num_pixels, sizeof(uGRB32_t));
+    frame_published = false;
+    frame_lock = spin_lock_init(spin_lock_claim_unused(true));
+    frame_buffer = malloc(_num_pixels * sizeof(uGRB32_t));
+    handoff_buffer = calloc(_num_pixels, sizeof(uGRB32_t));
+
+    // Effect pool, each effect draws into its own layer
+    fx_pool_size = max_effects;
+    fx_pool = calloc(max_effects, sizeof(FX_t));
+    for (uint16_t i = 0; i < max_effects; i++) {
+        fx_pool[i].layer = malloc(_num_pixels * sizeof(uGRB32_t));
     }
 
     // Initialize masks
@@ -239,20 +782,159 @@ void ws2812b_init(PIO _pio, uint8_t gpio, uint16_t _num_pixels) {
     memset(no_mask, 1, _num_pixels);
     ws2812b_clear_mask();
 
-    add_repeating_timer_ms(5, render, NULL, &rendering_timer); // A 5ms timer caps framerate to 200fps
+    // Per-pixel brightness and dithering state
+    level_brightness[0] = 255;
+    level_pixels[0] = _num_pixels;
+    pixel_level = calloc(_num_pixels, sizeof(uint8_t));
+    pixel_scale = calloc(_num_pixels, sizeof(uint16_t));
+    dither_error = calloc(_num_pixels * 3, sizeof(uint8_t));
+
+    // Frames are sent by DMA from a staging buffer, paced by the PIO TX FIFO
+    staging_buffer = malloc(_num_pixels * sizeof(uint32_t));
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(config.pio, config.pio_sm, true));
+    dma_channel_configure(dma_chan, &c, &config.pio->txf[config.pio_sm], staging_buffer, dma_words, false);
+    dma_channel_set_irq0_enabled(dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, dma_complete, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
 }
 
 /**
- * @brief Request a render of the current buffer state
+ * @brief Initialize the state machine with the default effect pool.
+ * @param pio PIO instance.
+ * @param gpio GPIO pin.
+ * @param num_pixels Number of pixels in the LED strip.
  */
-void ws2812b_render() {
+void ws2812b_init(PIO _pio, uint8_t gpio, uint16_t _num_pixels) {
+    ws2812b_init_ex(_pio, gpio, _num_pixels, MAX_EFFECTS);
+}
+
+/**
+ * @brief Initialize the state machine.
+ * @param pio PIO instance.
+ * @param gpio GPIO pin.
+ * @param num_pixels Number of pixels in the LED strip.
+ * @param max_effects Number of effects that can run at the same time.
+ */
+void ws2812b_init_ex(PIO _pio, uint8_t gpio, uint16_t _num_pixels, uint16_t max_effects) {
+    config.pio = _pio;
+    config.pio_sm = pio_claim_unused_sm(_pio, true);
+    uint offset = pio_add_program(_pio, &ws2812_program);
+    ws2812_program_init(_pio, config.pio_sm, offset, gpio, WS2812B_FREQ_HZ, WS2812B_IS_RGBW);
+    config.num_strips = 1;
+    config.strip_pixels = _num_pixels;
+    words_per_pixel = 1;
+    setup(_num_pixels, max_effects, _num_pixels);
+}
+
+/**
+ * @brief Initialize the state machine for strips driven in parallel.
+ * @param pio PIO instance.
+ * @param gpio_base GPIO pin of the first strip, the others follow consecutively.
+ * @param num_strips Number of strips (1-8).
+ * @param strip_pixels Number of pixels in each strip, at most 65535 in all.
+ * @param max_effects Number of effects that can run at the same time.
+ */
+void ws2812b_init_parallel(PIO _pio, uint8_t gpio_base, uint8_t num_strips, uint16_t strip_pixels, uint16_t max_effects) {
+    if(num_strips < 1) num_strips = 1;
+    if(num_strips > WS2812B_MAX_STRIPS) num_strips = WS2812B_MAX_STRIPS;
+    // All the strips share one buffer indexed by 16 bits
+    if(strip_pixels > UINT16_MAX / num_strips) strip_pixels = UINT16_MAX / num_strips;
+    config.pio = _pio;
+    config.pio_sm = pio_claim_unused_sm(_pio, true);
+    uint offset = pio_add_program(_pio, &ws2812_parallel_program);
+    ws2812_parallel_program_init(_pio, config.pio_sm, offset, gpio_base, num_strips, WS2812B_FREQ_HZ);
+    config.num_strips = num_strips;
+    config.strip_pixels = strip_pixels;
+    words_per_pixel = 24 / 4; // The PIO program shifts out 4 bit-planes per word
+    plane_buffer = malloc(strip_pixels * words_per_pixel * sizeof(uint32_t));
+    setup(num_strips * strip_pixels, max_effects, strip_pixels * words_per_pixel);
+}
+
+/**
+ * @brief Get the index of a pixel of one of the parallel strips.
+ * @param strip Strip index.
+ * @param index Pixel index within the strip.
+ * @return Pixel index in the buffer.
+ */
+uint16_t ws2812b_strip_pixel(uint8_t strip, uint16_t index) {
+    return strip * config.strip_pixels + index;
+}
+
+/**
+ * @brief Request a frame without publishing the buffer
+ * Used by the effects and the setters, so a frame being drawn by the
+ * application is never sent half done.
+ */
+static void request_frame() {
     request_render = true;
+    schedule_render();
+}
+
+/**
+ * @brief Write the pixels left by stopped effects into the back buffer.
+ * Called before the application draws, so it draws over them as it would
+ * have drawn over the effect. They stay laid over the sent frames until the
+ * buffer is published.
+ */
+static void apply_handoff() {
+    uint32_t irq_state = spin_lock_blocking(frame_lock);
+    for(uint32_t i=0; i<config.num_pixels; i++) {
+        uGRB32_t h = handoff_buffer[i];
+        if((h & HANDOFF_PENDING) != HANDOFF_PENDING) continue;
+        ws2812b_buffer[i] = h & 0xffffffu;
+        handoff_buffer[i] = HANDOFF_APPLIED | ws2812b_buffer[i];
+    }
+    handoff_pending = false;
+    spin_unlock(frame_lock, irq_state);
+}
+
+/**
+ * @brief Hand the pixels of stopped effects to the back buffer, if there are any.
+ */
+static inline void take_handoff() {
+    if(handoff_pending) apply_handoff();
+}
+
+/**
+ * @brief Publish the buffer and request a render
+ * The buffer is swapped with the published frame under a spinlock and then
+ * copied back, so drawing goes on from the frame just published while the
+ * renderer only ever sees complete frames. Pixels of stopped effects not
+ * handed over yet are written into it first. The alarms never write the
+ * published frame, so it can be copied after the lock is released. The frame
+ * is sent from an alarm, at most at the rate set with ws2812b_config_set_max_fps.
+ */
+void ws2812b_render() {
+    uint32_t irq_state = spin_lock_blocking(frame_lock);
+    if(handoff_active) {
+        for(uint32_t i=0; i<config.num_pixels; i++) {
+            uGRB32_t h = handoff_buffer[i];
+            if((h & HANDOFF_PENDING) == HANDOFF_PENDING) ws2812b_buffer[i] = h & 0xffffffu;
+            handoff_buffer[i] = 0;
+        }
+        handoff_pending = false;
+        handoff_active = false;
+    }
+    uGRB32_t *published = ws2812b_buffer;
+    ws2812b_buffer = ready_buffer;
+    ready_buffer = published;
+    frame_published = true;
+    spin_unlock(frame_lock, irq_state);
+
+    memcpy(ws2812b_buffer, published, config.num_pixels * sizeof(uGRB32_t));
+    request_frame();
 }
 
 /**
  * @brief Clear the WS2812B buffer and request a render
  */
 void ws2812b_clear() {
+    take_handoff();
     for(uint32_t i=0; i<config.num_pixels; i++) {
         ws2812b_buffer[i] = 0;
     }
@@ -265,6 +947,7 @@ void ws2812b_clear() {
  * @param grb 24-bit GRB color value
  */
 void ws2812b_put(uint16_t pixel, uGRB32_t grb) {
+    take_handoff();
     ws2812b_buffer[pixel] = grb;
 }
 
@@ -280,6 +963,7 @@ void ws2812b_fill(uint32_t from, uint32_t to, uGRB32_t grb) {
         from = to;
         to = temp;
     }
+    take_handoff();
     for(uint32_t i = from; i <= to; i++) {
         ws2812b_buffer[i] = grb;
     }
@@ -290,7 +974,140 @@ void ws2812b_fill(uint32_t from, uint32_t to, uGRB32_t grb) {
  * @param grb 24-bit GRB color value
  */
 void ws2812b_fill_all(uGRB32_t grb) {
-    ws2812b_fill(0, config.num_pixels, grb);
+    ws2812b_fill(0, config.num_pixels - 1, grb);
+}
+
+/* Matrix functions */
+
+/**
+ * @brief Lay the pixels out as a matrix
+ * The pixel index of every point is computed once here, so the drawing
+ * functions only look it up and nothing is transformed when rendering.
+ * @param width Width of the matrix in pixels, before rotation
+ * @param height Height of the matrix in pixels, before rotation
+ * @param layout WS2812B_MATRIX_* flags describing the wiring
+ * @param rotation Rotation of the image on the matrix
+ * @return False if the matrix has more pixels than the strip or memory ran out
+ */
+bool ws2812b_matrix_init(uint16_t width, uint16_t height, uint8_t layout, ws2812b_rotation_t rotation) {
+    uint32_t size = width * height;
+    if(size > config.num_pixels) return false;
+    uint16_t *map = realloc(matrix_map, size * sizeof(uint16_t));
+    if(!map && size) return false;
+    matrix_map = map;
+
+    bool swap = rotation == WS2812B_ROTATE_90 || rotation == WS2812B_ROTATE_270;
+    config.matrix_width = swap ? height : width;
+    config.matrix_height = swap ? width : height;
+    for(uint32_t y=0; y<config.matrix_height; y++) {
+        for(uint32_t x=0; x<config.matrix_width; x++) {
+            // Point on the matrix before rotation
+            uint32_t px = x, py = y;
+            switch(rotation) {
+                case WS2812B_ROTATE_90:  px = width - 1 - y; py = x; break;
+                case WS2812B_ROTATE_180: px = width - 1 - x; py = height - 1 - y; break;
+                case WS2812B_ROTATE_270: px = y; py = height - 1 - x; break;
+                default: break;
+            }
+            // Position along the wiring
+            uint32_t row = (layout & WS2812B_MATRIX_BOTTOM_UP) ? height - 1 - py : py;
+            bool reversed = (layout & WS2812B_MATRIX_RIGHT_TO_LEFT) != 0;
+            if((layout & WS2812B_MATRIX_SERPENTINE) && (row & 1u)) reversed = !reversed;
+            uint32_t col = reversed ? width - 1 - px : px;
+            matrix_map[y * config.matrix_width + x] = row * width + col;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the pixel index at a point of the matrix
+ * @param x Column, 0 on the left
+ * @param y Row, 0 on the top
+ * @return Pixel index, WS2812B_NO_PIXEL outside the matrix
+ */
+uint16_t ws2812b_matrix_index(int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= config.matrix_width || y >= config.matrix_height) return WS2812B_NO_PIXEL;
+    return matrix_map[y * config.matrix_width + x];
+}
+
+/**
+ * @brief Set the color of a pixel of the matrix
+ * @param x Column
+ * @param y Row
+ * @param grb 24-bit GRB color value
+ */
+void ws2812b_put_xy(int32_t x, int32_t y, uGRB32_t grb) {
+    uint16_t pixel = ws2812b_matrix_index(x, y);
+    take_handoff();
+    if(pixel != WS2812B_NO_PIXEL) ws2812b_buffer[pixel] = grb;
+}
+
+/**
+ * @brief Fill a rectangle of the matrix
+ * @param x Left column
+ * @param y Top row
+ * @param w Width
+ * @param h Height
+ * @param grb 24-bit GRB color value
+ */
+void ws2812b_fill_rect(int32_t x, int32_t y, uint16_t w, uint16_t h, uGRB32_t grb) {
+    int32_t x_end = x + w, y_end = y + h;
+    if(x < 0) x = 0;
+    if(y < 0) y = 0;
+    if(x_end > config.matrix_width) x_end = config.matrix_width;
+    if(y_end > config.matrix_height) y_end = config.matrix_height;
+    take_handoff();
+    for(int32_t j=y; j<y_end; j++) {
+        const uint16_t *row = &matrix_map[j * config.matrix_width];
+        for(int32_t i=x; i<x_end; i++) {
+            ws2812b_buffer[row[i]] = grb;
+        }
+    }
+}
+
+/**
+ * @brief Draw a line on the matrix
+ * @param x0 Start column
+ * @param y0 Start row
+ * @param x1 End column
+ * @param y1 End row
+ * @param grb 24-bit GRB color value
+ */
+void ws2812b_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uGRB32_t grb) {
+    // Bresenham, stepping along both axes with a shared error term
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    for(;;) {
+        ws2812b_put_xy(x0, y0, grb);
+        if(x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if(e2 >= dy) { err += dy; x0 += sx; }
+        if(e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+/**
+ * @brief Copy an image onto the matrix
+ * @param x Column of the left edge of the image
+ * @param y Row of the top edge of the image
+ * @param image Image data, row by row from the top left
+ * @param w Width of the image
+ * @param h Height of the image
+ */
+void ws2812b_blit(int32_t x, int32_t y, const uGRB32_t *image, uint16_t w, uint16_t h) {
+    int32_t i_start = x < 0 ? -x : 0, j_start = y < 0 ? -y : 0;
+    int32_t i_end = config.matrix_width - x, j_end = config.matrix_height - y;
+    if(i_end > w) i_end = w;
+    if(j_end > h) j_end = h;
+    take_handoff();
+    for(int32_t j=j_start; j<j_end; j++) {
+        const uint16_t *row = &matrix_map[(y + j) * config.matrix_width + x];
+        for(int32_t i=i_start; i<i_end; i++) {
+            ws2812b_buffer[row[i]] = image[j * w + i];
+        }
+    }
 }
 
 /* Setters */
@@ -303,6 +1120,14 @@ void ws2812b_config_set_fps(uint16_t fps) {
     config.animation_step_ms = 1000 / fps;
 }
 
+/**
+ * @brief Set the maximum rate at which frames are sent to the LEDs
+ * @param fps Frames per second
+ */
+void ws2812b_config_set_max_fps(uint16_t fps) {
+    config.frame_interval_us = 1000000 / fps;
+}
+
 /**
  * @brief Set the frame rate for a specific effect
  * @param FX Effect descriptor
@@ -318,6 +1143,16 @@ void ws2812b_set_fps(FX_t *FX, uint16_t fps) {
  */
 void ws2812b_set_inverted(bool inverted) {
     config.inverted = inverted;
+    build_luts();
+}
+
+/**
+ * @brief Set the gamma correction exponent
+ * @param gamma Exponent applied to every channel, 1.0 is linear, 2.2-2.8 suits most LEDs
+ */
+void ws2812b_set_gamma(float gamma) {
+    config.gamma = (gamma > 0.0f ? gamma : 1.0f);
+    build_luts();
 }
 
 /**
@@ -340,11 +1175,105 @@ void ws2812b_set_callback(FX_t *FX, void (*callback)(void *user_data)) {
 
 /**
  * @brief Set the global dimming level
+ * Kept for compatibility, each level halves the brightness.
  * @param dim Dimming level (0-7)
  */
 void ws2812b_set_global_dimming(uint8_t dim) {
     if(dim > 7) dim = 7;
-    config.global_dimming = dim;
+    ws2812b_set_brightness(255 >> dim);
+}
+
+/**
+ * @brief Set the global brightness
+ * @param level Brightness (0-255)
+ */
+void ws2812b_set_brightness(uint8_t level) {
+    config.brightness = level;
+    build_luts();
+}
+
+/**
+ * @brief Set the brightness of a single pixel, on top of the global one
+ * Pixels at the same level share a lookup table, built when the level is
+ * first used. The table of the previous level is released first, so a pixel
+ * can always move to a level that only it was using. When all the tables
+ * are taken by other levels the pixel is scaled with a multiply per channel
+ * instead, with the same result.
+ * @param pixel Pixel index
+ * @param level Brightness (0-255)
+ * @return True if the level has a lookup table, false if the pixel is scaled by a multiply
+ */
+bool ws2812b_set_pixel_brightness(uint16_t pixel, uint8_t level) {
+    uint8_t old = pixel_level[pixel];
+    level_pixels[old]--;
+    uint32_t free_slot = 0;
+    uint32_t slot = 0;
+    if(level != 255) {
+        for(uint32_t s=1; s<=WS2812B_PIXEL_LEVELS && !slot; s++) {
+            if(!level_pixels[s]) {
+                if(!free_slot) free_slot = s;
+            } else if(level_brightness[s] == level) {
+                slot = s;
+            }
+        }
+        if(!slot && free_slot) {
+            slot = free_slot;
+            level_brightness[slot] = level;
+            build_level_lut(slot);
+        } else if(!slot) {
+            slot = LEVEL_SCALED;
+            pixel_scale[pixel] = brightness_scale(level);
+        }
+    }
+    level_pixels[slot]++;
+    pixel_level[pixel] = slot;
+    return slot != LEVEL_SCALED;
+}
+
+/**
+ * @brief Enable temporal dithering
+ * The fraction lost when scaling a channel to 8 bits is carried over to the
+ * next frame, so low brightness levels keep their hue and steps. While a
+ * fraction is left frames keep being sent at the maximum frame rate.
+ * @param enabled True to dither, false to round
+ */
+void ws2812b_set_dithering(bool enabled) {
+    if(enabled && !config.dithering) {
+        memset(dither_error, 0, config.num_pixels * 3);
+    }
+    config.dithering = enabled;
+    request_frame();
+}
+
+/**
+ * @brief Limit the estimated current of the LEDs
+ * The current of a frame is estimated from the levels sent, WS2812B_CHANNEL_MA
+ * per channel at full level plus WS2812B_IDLE_MA per pixel. Frames above the
+ * budget are scaled down uniformly until they fit.
+ * @param milliamps Budget in mA, 0 to disable the limit
+ */
+void ws2812b_set_power_budget(uint32_t milliamps) {
+    config.power_budget_ma = milliamps;
+    request_frame();
+}
+
+/**
+ * @brief Get the estimated current of the frames and the number of limited frames
+ * @return Power statistics
+ */
+const struct ws2812b_power_stats* ws2812b_get_power_stats() {
+    if(power_stats_stale) {
+        // Cleared first, a frame sent meanwhile sets it again
+        power_stats_stale = false;
+        uint32_t channel_sum = 0;
+        for(uint32_t i=0; i<config.num_pixels; i++) {
+            uint32_t w = staging_buffer[i];
+            channel_sum += (w >> 24u) + ((w >> 16u) & 0xffu) + ((w >> 8u) & 0xffu);
+        }
+        power_stats.requested_ma = config.num_pixels * WS2812B_IDLE_MA + (channel_sum * WS2812B_CHANNEL_MA + 254) / 255;
+        power_stats.frame_ma = power_stats.requested_ma;
+    }
+    return &power_stats;
 }
 
 /**
@@ -362,6 +1291,170 @@ void ws2812b_clear_mask() {
     config.global_mask = no_mask;
 }
 
+/* Effect engine */
+
+/**
+ * @brief Flag set while the frame clock steps the effects.
+ */
+static bool in_tick;
+
+/**
+ * @brief Draw a pixel in the layer of an effect.
+ * @param FX Effect descriptor
+ * @param pixel Pixel index, pixels past the end of the strip are ignored
+ * @param grb 24-bit GRB color value
+ */
+static inline void layer_put(FX_t *FX, uint32_t pixel, uGRB32_t grb) {
+    if (pixel < config.num_pixels) {
+        FX->layer[pixel] = 0xff000000u | grb;
+    }
+}
+
+/**
+ * @brief Draw a point of an 8 pixel wide image in the layer of an effect.
+ * With a matrix set up the point is looked up in its map and clipped to it,
+ * otherwise pixels are numbered row by row from the top left, 8 per row.
+ * @param FX Effect descriptor
+ * @param x Column
+ * @param y Row
+ * @param grb 24-bit GRB color value
+ */
+static inline void layer_put_xy(FX_t *FX, int32_t x, int32_t y, uGRB32_t grb) {
+    if (config.matrix_width) {
+        layer_put(FX, ws2812b_matrix_index(x, y), grb);
+    } else if (x >= 0 && x < 8 && y >= 0) {
+        layer_put(FX, y * 8 + x, grb);
+    }
+}
+
+/**
+ * @brief Fill a range of pixels in the layer of an effect.
+ * @param FX Effect descriptor
+ * @param from Start pixel index
+ * @param to End pixel index
+ * @param grb 24-bit GRB color value
+ */
+static void layer_fill(FX_t *FX, uint32_t from, uint32_t to, uGRB32_t grb) {
+    if(from > to) {
+        uint32_t temp = from;
+        from = to;
+        to = temp;
+    }
+    for(uint32_t i = from; i <= to; i++) {
+        layer_put(FX, i, grb);
+    }
+}
+
+/**
+ * @brief Time until the next effect step.
+ * @return Delay in microseconds, 0 if no effect is running.
+ */
+static int64_t next_step_delay() {
+    uint64_t next = UINT64_MAX;
+    for (uint16_t i = 0; i < fx_pool_size; i++) {
+        if (fx_pool[i].running && fx_pool[i].due_us < next) {
+            next = fx_pool[i].due_us;
+        }
+    }
+    if (next == UINT64_MAX) return 0;
+    uint64_t now = time_us_64();
+    return (next > now ? next - now : 1);
+}
+
+/**
+ * @brief Stop an effect, keeping what it shows.
+ * The layer is blended over the last published frame into the handoff buffer.
+ * The renderer lays it over the frames it sends and the application side
+ * writes it into the back buffer before the next drawing call or
+ * ws2812b_render, so what the effect showed last stays on the strip as if it
+ * had been drawn there. The back buffer itself is never written from here.
+ * @param FX Effect descriptor
+ */
+static void stop_effect(FX_t *FX) {
+    FX->running = false;
+    FX->ending = false;
+    const uGRB32_t *src = FX->layer;
+    uint32_t opacity = FX->opacity + 1;
+    uint32_t irq_state = spin_lock_blocking(frame_lock);
+    const uGRB32_t *base = frame_published ? ready_buffer : front_buffer;
+    for (uint32_t i = 0; i < config.num_pixels; i++) {
+        uint32_t a = ((src[i] >> 24u) * opacity) >> 8u;
+        if (!a) continue;
+        // Over what an effect stopped before left, if anything
+        uGRB32_t h = handoff_buffer[i];
+        uGRB32_t d = h ? h & 0xffffffu : base[i];
+        handoff_buffer[i] = HANDOFF_PENDING | blend_pixel(d, src[i] & 0xffffffu, FX->blend, a);
+    }
+    handoff_pending = true;
+    handoff_active = true;
+    spin_unlock(frame_lock, irq_state);
+    request_frame();
+}
+
+/**
+ * @brief Stop an effect at its end and call its callback.
+ * @param FX Effect descriptor
+ */
+static void finish_effect(FX_t *FX) {
+    stop_effect(FX);
+    FX->callback(FX);
+}
+
+/**
+ * @brief Frame clock, steps every effect that is due.
+ * A single alarm serves all the effects; it is rearmed for the next due
+ * effect and stops when no effect is running.
+ * @param id Alarm ID
+ * @param user_data Unused
+ * @return Time until the next call in microseconds, 0 when idle
+ */
+static int64_t frame_tick(alarm_id_t id, void *user_data) {
+    uint64_t now = time_us_64();
+    in_tick = true;
+    for (uint16_t i = 0; i < fx_pool_size; i++) {
+        FX_t *FX = &fx_pool[i];
+        if (!FX->running || FX->due_us > now) continue;
+        if (FX->canceled) {
+            stop_effect(FX);
+            continue;
+        }
+        int64_t delay_us = FX->step_function(FX);
+        // A finished effect may already have been reused by its callback
+        if (delay_us) FX->due_us = now + delay_us;
+    }
+    in_tick = false;
+
+    int64_t delay_us = next_step_delay();
+    if (!delay_us) frame_clock = 0;
+    return delay_us;
+}
+
+/**
+ * @brief Arm the frame clock for the next due effect.
+ */
+static void wake_clock() {
+    if (in_tick) return; // Rearmed when the tick returns
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (frame_clock) cancel_alarm(frame_clock);
+    frame_clock = add_alarm_in_us(next_step_delay(), frame_tick, NULL, true);
+    restore_interrupts(irq_state);
+}
+
+/**
+ * @brief Start an effect on the frame clock.
+ * @param FX Effect descriptor
+ * @param step_function Function drawing a step, returning the delay until the next one
+ * @param delay_ms Delay until the first step in milliseconds
+ * @return Effect descriptor
+ */
+static FX_t* start_effect(FX_t *FX, int64_t (*step_function)(FX_t *FX), uint32_t delay_ms) {
+    FX->step_function = step_function;
+    FX->due_us = time_us_64() + delay_ms * 1000;
+    FX->running = true;
+    wake_clock();
+    return FX;
+}
+
 /* Text functions */
 
 /**
@@ -370,124 +1463,121 @@ void ws2812b_clear_mask() {
  * @return Pointer to the bitmap data
  */
 static char* get_CP0_EU(uint32_t codepoint) {
-    uint16_t index = 0;
-    while (index < 256 && CHARMAP_CP0_EU[index] != codepoint) ++index;
-    if(index < 0 || index > 255) index = 215; // CHARMAP_CP0_EU[215] is a bullet glyph.
-                                              // Use 0 for a blank one.
-    return (char *)CP0_EU_8x8[index];
+    // Code points missing from the charset get CP0_EU_FALLBACK_GLYPH, a bullet.
+    return (char *)CP0_EU_8x8[cp0_eu_glyph(codepoint)];
 }
 
 /**
  * @brief Type a character on the WS2812B strip
- * @param id Alarm ID
- * @param user_data Effect descriptor
+ * @param FX Effect descriptor
  * @return Time until the next call in microseconds
  */
-static int64_t type_character(alarm_id_t id, void *user_data) {
-    FX_t* FX = (FX_t*)user_data;
-    static bool is_gap; // Used to 'blink' between characters
-    if(is_gap && !FX->ending) {
-        ws2812b_fill_all(FX->colors[1]);
-        ws2812b_render();
-        is_gap = false;
+static int64_t type_character(FX_t *FX) {
+    if(FX->is_gap && !FX->ending) { // 'Blink' between characters
+        layer_fill(FX, 0, config.num_pixels - 1, FX->colors[1]);
+        request_frame();
+        FX->is_gap = false;
         return FX->gap_ms*1000;
     }
-    if(utf8_next(&ITER)) {
-        Character = utf8_getchar(&ITER);
+    if(utf8_next(&FX->iter)) {
         // Lookahead
-        if(!utf8_next(&ITER)) { FX->ending = true; }
-        utf8_previous(&ITER); // Revert the lookahead step
+        if(!utf8_next(&FX->iter)) { FX->ending = true; }
+        utf8_previous(&FX->iter); // Revert the lookahead step
 
-        const char *bitmap = get_CP0_EU(ITER.codepoint);
+        const char *bitmap = get_CP0_EU(FX->iter.codepoint);
         uint8_t set;
-        for (uint8_t x=0; x<8; x++) {
-            for (uint8_t y=0; y<8; y++) {
-                set = bitmap[x] & 1 << y;
-                ws2812b_buffer[x * 8 + (7 - y)] =
-                            (set ? FX->colors[0] : FX->colors[1]);
+        for (uint8_t y=0; y<8; y++) {
+            for (uint8_t x=0; x<8; x++) {
+                set = bitmap[y] & 1 << (7 - x); // Leftmost column in the msb
+                layer_put_xy(FX, x, y, (set ? FX->colors[0] : FX->colors[1]));
             }
         }
-        ws2812b_render();
+        request_frame();
     } else { // str == 0x00, end of string
-        is_gap = false;
-        FX->running = false;
-        FX->ending = false;
         if(FX->clear_on_end) {
-            ws2812b_fill_all(FX->colors[1]);
-            ws2812b_render();
+            layer_fill(FX, 0, config.num_pixels - 1, FX->colors[1]);
         }
-        FX->callback(FX);
-        return false;
+        finish_effect(FX);
+        return 0;
     }
-    is_gap = true; // Set flag for the next call
+    FX->is_gap = true; // Set flag for the next call
     
     return FX->step_ms*1000;
 }
 
 /**
  * @brief Scroll a string of text on the WS2812B strip
- * @param id Alarm ID
- * @param user_data Effect descriptor
+ * @param FX Effect descriptor
  * @return Time until the next call in microseconds
  */
-static int64_t scroll_text(alarm_id_t id, void *user_data) {
-    FX_t* FX = (FX_t*)user_data;
-    uint8_t set;
-    static uint8_t pad_end;
-
-    if (FX->cursor % 8 == 0) {
-        if(utf8_next(&ITER)) {
-            Character = utf8_getchar(&ITER);
-            // Lookahead
-            if(!utf8_next(&ITER)) {
-                FX->ending = true;
-                pad_end = 2; // Padding the end of the string with two empty buffer pages
-            }
-            utf8_previous(&ITER); // Revert the lookahead step
-
-            // For each character, copy the bitmap to one of the two double_buffer pages.
-            const char *bitmap = get_CP0_EU(ITER.codepoint);
-            uint8_t buf_index = FX->buf_crs < 8 ? 0 : 1;
-            for (uint8_t y=0; y<8; y++) {
-                for (uint8_t x=0; x<8; x++) {
-                    set = bitmap[y] & 1 << x;
-                    double_buffer[y][(8 * buf_index) + x] = set;
-                }
-            }
-        } else { // str == 0x00, end of string
-            uint8_t buf_index = FX->buf_crs < 8 ? 0 : 1;
-            for (uint8_t y=0; y<8; y++) {
-                for (uint8_t x=0; x<8; x++) {
-                    double_buffer[y][(8 * buf_index) + x] = 0x0;
-                }
-            }
-            pad_end--;
-            if(pad_end == 0) {
-                FX->running = false;
-                FX->callback(FX);
-                return false;
-            }
-        }
+static int64_t scroll_text(FX_t *FX) {
+    // The text enters at the right edge and leaves past the left one whatever
+    // the width, 8 columns without a matrix.
+    int32_t width = config.matrix_width ? config.matrix_width : 8;
+    if ((int32_t)FX->cursor + 16 >= FX->text_width + width) {
+        finish_effect(FX);
+        return 0;
     }
 
-    // On each call, copy 8x8 bits from double_buffer, starting at FX->buf_crs,
-    // which is incremented after each call and wrapped at sizeof(double_buffer).
-    for (uint8_t y = 0; y < 8; y++) {
-        uint8_t count = 0;
-        for (uint8_t x = FX->buf_crs; count < 8; x = (x + 1) % 16) {
-            set = double_buffer[y][15-x];
-            ws2812b_buffer[y*8+count] = (set ? FX->colors[0] : FX->colors[1]);
-            count++;
+    // On each call, show the columns of text_columns starting at FX->cursor,
+    // shifted so the empty page in front of the text ends at the right edge.
+    int32_t start = (int32_t)FX->cursor + 8 - width;
+    for (int32_t x = 0; x < width; x++) {
+        int32_t i = start + x;
+        uint8_t column = (i >= 0 && i < FX->text_width) ? FX->text_columns[i] : 0;
+        for (uint8_t y = 0; y < 8; y++) {
+            layer_put_xy(FX, x, y, (column & 1) ? FX->colors[0] : FX->colors[1]);
+            column >>= 1;
         }
     }
-    FX->buf_crs++;
-    FX->buf_crs = FX->buf_crs % 16;
-    ws2812b_render();
+    request_frame();
 
     FX->cursor++;
     return FX->step_ms*1000;
 }
 
+/**
+ * @brief Decode a string into the column strip of a scrolling text effect.
+ * The glyphs are preceded and followed by an empty 8x8 page, so the text
+ * scrolls in from the right edge and out past the left one.
+ * @param FX Effect descriptor
+ * @param str String to decode
+ * @return False if the strip could not be allocated
+ */
+static bool decode_text_columns(FX_t *FX, const char *str) {
+    utf8_iter iter;
+    uint32_t glyphs = 0;
+    utf8_init(&iter, str);
+    while (utf8_next(&iter)) glyphs++;
+
+    uint32_t width = (glyphs + 2) * 8;
+    if (width > UINT16_MAX) return false;
+    if (width > FX->text_capacity) {
+        uint8_t *columns = realloc(FX->text_columns, width);
+        if (!columns) return false;
+        FX->text_columns = columns;
+        FX->text_capacity = width;
+    }
+    memset(FX->text_columns, 0, width);
+    FX->text_width = width;
+
+    // Glyph rows hold the leftmost column in the msb; turn them into columns
+    // with the top row in bit 0.
+    uint8_t *columns = FX->text_columns + 8;
+    utf8_init(&iter, str);
+    while (utf8_next(&iter)) {
+        const char *bitmap = get_CP0_EU(iter.codepoint);
+        for (uint8_t y = 0; y < 8; y++) {
+            uint8_t row = bitmap[y];
+            for (uint8_t x = 0; x < 8; x++) {
+                columns[x] |= ((row >> (7 - x)) & 1) << y;
+            }
+        }
+        columns += 8;
+    }
+    return true;
+}
+
 /**
  * @brief Start a text typing effect on the WS2812B strip
  * @param str String to type
@@ -496,19 +1586,19 @@ static int64_t scroll_text(alarm_id_t id, void *user_data) {
  * @return Pointer to the effect descriptor
  */
 FX_t* ws2812b_text_type(char *str, uGRB32_t grb, uint16_t delay) {
-    FX_text.callback = noop;
-    FX_text.str = str;
-    FX_text.colors[0] = grb;
-    FX_text.colors[1] = 0x0;
-    FX_text.step_ms = delay;
-    FX_text.running = true;
-    FX_text.ending = false;
-    FX_text.gap_ms = 50;
-    FX_text.clear_on_end = true;
-    utf8_init(&ITER, str);
-    if (frame_by_frame_timer) cancel_alarm(frame_by_frame_timer);
-    frame_by_frame_timer = add_alarm_in_ms(delay, type_character, &FX_text, false);
-    return &FX_text;
+    FX_t *FX = get_available_effect();
+    if (!FX) return NULL;
+    FX->callback = noop;
+    FX->str = str;
+    FX->colors[0] = grb;
+    FX->colors[1] = 0x0;
+    FX->step_ms = delay;
+    FX->ending = false;
+    FX->gap_ms = 50;
+    FX->is_gap = false;
+    FX->clear_on_end = true;
+    utf8_init(&FX->iter, str);
+    return start_effect(FX, type_character, delay);
 }
 
 /**
@@ -519,70 +1609,114 @@ FX_t* ws2812b_text_type(char *str, uGRB32_t grb, uint16_t delay) {
  * @return Pointer to the effect descriptor
  */
 FX_t* ws2812b_text_scroll(char *str, uGRB32_t grb, uint16_t delay) {
-    FX_text.callback = noop;
-    FX_text.str = str;
-    FX_text.cursor = 0;
-    FX_text.buf_crs = 0;
-    FX_text.colors[0] = grb;
-    FX_text.colors[1] = 0x0;
-    FX_text.step_ms = delay;
-    FX_text.running = true;
-    FX_text.ending = false;
-    FX_text.clear_on_end = true; // Not in use for this type of effect
-    utf8_init(&ITER, str);
-    if (frame_by_frame_timer) cancel_alarm(frame_by_frame_timer);
-    frame_by_frame_timer = add_alarm_in_ms(delay, scroll_text, &FX_text, false);
-    return &FX_text;
+    FX_t *FX = get_available_effect();
+    if (!FX) return NULL;
+    FX->callback = noop;
+    FX->str = str;
+    FX->cursor = 0;
+    if (!decode_text_columns(FX, str)) return NULL;
+    FX->colors[0] = grb;
+    FX->colors[1] = 0x0;
+    FX->step_ms = delay;
+    FX->ending = false;
+    FX->clear_on_end = true; // Not in use for this type of effect
+    return start_effect(FX, scroll_text, delay);
 }
 
 /* Sprite functions */
 
 /**
  * @brief Display a sprite on the WS2812B strip
- * @param sprite Pointer to the sprite data
+ * With a matrix set up the sprite is drawn at its top left corner and clipped
+ * to it, otherwise it fills the first 64 pixels.
+ * @param sprite Pointer to the 8x8 sprite data
  */
 void ws2812b_sprite(const uGRB32_t *sprite) {
-    for (uint8_t x=0; x<8; x++) {
-        for (uint8_t y=0; y<8; y++) {
-            ws2812b_buffer[x*8+y] = sprite[x*8+y];
-        }
+    if(config.matrix_width) {
+        ws2812b_blit(0, 0, sprite, 8, 8);
+        return;
+    }
+    take_handoff();
+    for(uint32_t i=0; i<64 && i<config.num_pixels; i++) {
+        ws2812b_buffer[i] = sprite[i];
     }
 }
 
 /**
  * @brief Display a tinted sprite on the WS2812B strip
- * @param sprite Pointer to the sprite data
+ * @param sprite Pointer to the 8x8 sprite data
  * @param grb 24-bit GRB color value for the tint
  */
 void ws2812b_sprite_tint(const uGRB32_t *sprite, uGRB32_t grb) {
-    for (uint8_t x=0; x<8; x++) {
-        for (uint8_t y=0; y<8; y++) {
-            bool set = sprite[x*8+y];
-            ws2812b_buffer[x*8+y] = (set ? grb : 0x0);
+    uGRB32_t tinted[64];
+    for(uint32_t i=0; i<64; i++) {
+        tinted[i] = (sprite[i] ? grb : 0x0);
+    }
+    ws2812b_sprite(tinted);
+}
+
+/**
+ * @brief Decode a frame of a palette-indexed spritesheet into the layer of an effect.
+ * Delta frames only draw the pixels that changed, the others are left as the
+ * previous frame drew them.
+ * @param FX Effect descriptor
+ * @param sheet Spritesheet
+ * @param frame Frame index
+ */
+static void decode_sheet_frame(FX_t *FX, const ws2812b_sheet_t *sheet, uint8_t frame) {
+    const uint8_t *data = sheet->data + sheet->offsets[frame];
+    uint8_t type = *data++;
+    bool four_bit = sheet->flags & WS2812B_SHEET_4BIT;
+    uint8_t keep = four_bit ? 0x0f : 0xff;
+    uint32_t i = 0;
+    while (i < sheet->pixels) {
+        uint32_t run = 1;
+        uint8_t index;
+        if (type & WS2812B_FRAME_RLE) {
+            if (four_bit) {
+                run = (*data >> 4u) + 1;
+                index = *data++ & 0x0fu;
+            } else {
+                run = *data++ + 1;
+                index = *data++;
+            }
+            if (run > sheet->pixels - i) run = sheet->pixels - i;
+        } else if (four_bit) {
+            index = (i & 1u) ? (*data++ >> 4u) : (*data & 0x0fu);
+        } else {
+            index = *data++;
+        }
+        if ((type & WS2812B_FRAME_DELTA) && index == keep) {
+            i += run;
+            continue;
+        }
+        uGRB32_t grb = sheet->palette[index];
+        while (run--) {
+            layer_put_xy(FX, i % 8, i / 8, grb);
+            i++;
         }
     }
 }
 
 /**
  * @brief Display a frame from a spritesheet on the WS2812B strip
- * @param id Alarm ID
- * @param user_data Effect descriptor
+ * @param FX Effect descriptor
  * @return Time until the next call in microseconds
  */
-static int64_t spritesheet_frame(alarm_id_t id, void *user_data) {
-    FX_t* FX = (FX_t*)user_data;
-    if(FX->canceled) {
-        FX->running = false;
-        return 0;
-    }
+static int64_t spritesheet_frame(FX_t *FX) {
     if(FX->ending) {
-        FX->running = false;
-        FX->ending = false;
-        FX->callback(FX);
+        finish_effect(FX);
         return 0;
     }
-    ws2812b_sprite(FX->spritesheet[FX->cursor]);
-    ws2812b_render();
+    if(FX->sheet) {
+        decode_sheet_frame(FX, FX->sheet, FX->cursor);
+    } else {
+        const uGRB32_t *sprite = FX->spritesheet[FX->cursor];
+        for (uint8_t i=0; i<64; i++) {
+            layer_put_xy(FX, i % 8, i / 8, sprite[i]);
+        }
+    }
+    request_frame();
     if(++FX->cursor >= FX->frames) {
         FX->cursor = 0;
         if(++FX->loop_counter >= FX->loops && FX->loops > 0) {
@@ -593,6 +1727,31 @@ static int64_t spritesheet_frame(alarm_id_t id, void *user_data) {
     return FX->step_ms*1000;
 }
 
+/**
+ * @brief Start a spritesheet animation from either kind of spritesheet
+ * @param spritesheet Pointer to the array of sprite frames, NULL for a packed sheet
+ * @param sheet Palette-indexed spritesheet, NULL for an array of frames
+ * @param frames Number of frames in the spritesheet
+ * @param delay Delay between frames in milliseconds
+ * @param loops Number of loops (0 for infinite)
+ * @return Pointer to the effect descriptor
+ */
+static FX_t* start_spritesheet(const uGRB32_t **spritesheet, const ws2812b_sheet_t *sheet,
+                               uint8_t frames, uint16_t delay, uint32_t loops) {
+    FX_t *FX = get_available_effect();
+    if (!FX) return NULL;
+    FX->callback = noop;
+    FX->spritesheet = spritesheet;
+    FX->sheet = sheet;
+    FX->cursor = 0;
+    FX->frames = frames;
+    FX->step_ms = delay;
+    FX->loops = loops;
+    FX->loop_counter = 0;
+    FX->ending = false;
+    return start_effect(FX, spritesheet_frame, delay);
+}
+
 /**
  * @brief Start a spritesheet animation on the WS2812B strip
  * @param spritesheet Pointer to the array of sprite frames
@@ -603,18 +1762,18 @@ static int64_t spritesheet_frame(alarm_id_t id, void *user_data) {
  */
 FX_t* ws2812b_spritesheet(const uGRB32_t **spritesheet, uint8_t frames,
                           uint16_t delay, uint32_t loops) {
-    FX_text.callback = noop;
-    FX_text.spritesheet = spritesheet;
-    FX_text.cursor = 0;
-    FX_text.frames = frames;
-    FX_text.step_ms = delay;
-    FX_text.loops = loops;
-    FX_text.loop_counter = 0;
-    FX_text.running = true;
-    FX_text.ending = false;
-    if (frame_by_frame_timer) cancel_alarm(frame_by_frame_timer);
-    frame_by_frame_timer = add_alarm_in_ms(delay, spritesheet_frame, &FX_text, false);
-    return &FX_text;
+    return start_spritesheet(spritesheet, NULL, frames, delay, loops);
+}
+
+/**
+ * @brief Start a palette-indexed spritesheet animation on the WS2812B strip
+ * @param sheet Spritesheet written by tools/img2grb.py -s
+ * @param delay Delay between frames in milliseconds
+ * @param loops Number of loops (0 for infinite)
+ * @return Pointer to the effect descriptor
+ */
+FX_t* ws2812b_spritesheet_packed(const ws2812b_sheet_t *sheet, uint16_t delay, uint32_t loops) {
+    return start_spritesheet(NULL, sheet, sheet->frames, delay, loops);
 }
 
 /* Procedural effects */
@@ -631,7 +1790,6 @@ param: eases the movement if true
  */
 static void fx_scan(void *user_data) {
     FX_t* FX = (FX_t*)user_data;
-    static uint16_t last_p = 0xffff;
 
     uint16_t p = FX->cursor;
     if(FX->param) { // Quadratic easing
@@ -643,10 +1801,9 @@ static void fx_scan(void *user_data) {
         uint32_t f = ee2;
         p = f * FX->end / 0xff;
     }
-    ws2812b_buffer[p] = FX->colors[0];
-    if(last_p <0xffff) ws2812b_buffer[last_p] = FX->colors[1];
-    if(FX->ending) last_p = 0xffff;
-    last_p = p;
+    layer_put(FX, p, FX->colors[0]);
+    if(FX->last_pixel < 0xffff) layer_put(FX, FX->last_pixel, FX->colors[1]);
+    FX->last_pixel = p;
 }
 
 /* FX_WIPE
@@ -660,8 +1817,8 @@ param: not used
  */
 static void fx_wipe(void *user_data) {
     FX_t* FX = (FX_t*)user_data;
-    ws2812b_fill(((FX->dir == 1) ? FX->start : FX->end),
-                 FX->cursor, FX->colors[0]);
+    layer_fill(FX, ((FX->dir == 1) ? FX->start : FX->end),
+               FX->cursor, FX->colors[0]);
 }
 
 /* FX_RANDOM
@@ -677,7 +1834,7 @@ static void fx_random(void *user_data) {
     FX_t* FX = (FX_t*)user_data;
     for(uint32_t i = FX->from; i <= FX->to; i++) {
         uint8_t c = rand() % 8;
-        ws2812b_put(i, FX->colors[c]);
+        layer_put(FX, i, FX->colors[c]);
         // It's hallWS2812Bgenic!
     }
 }
@@ -694,7 +1851,7 @@ param: duration of the effect in steps
 static void fx_blink(void *user_data) {
     FX_t* FX = (FX_t*)user_data;
     bool is_odd = (FX->cursor) % 2;
-    ws2812b_fill(FX->from, FX->to, FX->colors[is_odd]);
+    layer_fill(FX, FX->from, FX->to, FX->colors[is_odd]);
 }
 
 /* FX_CHASER
@@ -712,7 +1869,7 @@ static void fx_chaser(void *user_data) {
     if (FX->param > 2 && FX->param <= 8) { wrap = FX->param;}
     for(uint32_t i = FX->start; i <= FX->end; i++) {
         uint8_t c = (FX->cursor + i) % wrap;
-        ws2812b_put(i, FX->colors[c]);
+        layer_put(FX, i, FX->colors[c]);
     }
 }
 
@@ -729,45 +1886,29 @@ Note: the effect won't work with global dimming set to high values
 static void fx_fade(void *user_data) {
     FX_t* FX = (FX_t*)user_data;
     if(FX->ending) return;
-    uint8_t g = (FX->colors[0] >> 16u) & 0xffu;
-    uint8_t r = (FX->colors[0] >> 8u) & 0xffu;
-    uint8_t b = FX->colors[0] & 0xffu;
     uint8_t brightness = (FX->dir ? FX->cursor : 100 - FX->cursor);
+    uint8_t level = (brightness * 653) >> 8; // 0-100 to 0-255 without a division
 
-    r = r * brightness / 100;
-    g = g * brightness / 100;
-    b = b * brightness / 100;
-    ws2812b_fill(FX->from, FX->to, ws2812b_rgb((uint8_t)r, (uint8_t)g, (uint8_t)b));
+    layer_fill(FX, FX->from, FX->to, ws2812b_scale_color(FX->colors[0], level));
 }
 
 /**
  * @brief Step function for animations
- * @param id Alarm ID
- * @param user_data Effect descriptor
+ * @param FX Effect descriptor
  * @return Time until the next call in microseconds
  */
-static int64_t animation_step(alarm_id_t id, void *user_data) {
-    FX_t* FX = (FX_t*)user_data;
-
-    if(FX->canceled) {
-        FX->running = false;
-        return 0;
-    }
-
+static int64_t animation_step(FX_t *FX) {
     if(FX->ending) {
         if(FX->clear_on_end) { // Cleanup
-            ws2812b_fill(FX->from, FX->to, 0x0);
-            ws2812b_render();
+            layer_fill(FX, FX->from, FX->to, 0x0);
         }
-        FX->callback(FX);
-        FX->running = false;
-        FX->ending = false;
+        finish_effect(FX);
         return 0; // Stop the animation
     }
 
     // Call the actual effect function 
-    FX->fx_function(user_data);
-    ws2812b_render();
+    FX->fx_function(FX);
+    request_frame();
 
     FX->cursor += FX->dir; // Update the cursor position for the next step
     
@@ -794,65 +1935,63 @@ static int64_t animation_step(alarm_id_t id, void *user_data) {
  */
 FX_t* ws2812b_animate(uint32_t from, uint32_t to, FX_mode_t mode,
                     const uGRB32_t colors[8], uint32_t loops, uint32_t param) {
-    uint8_t seg_id = get_available_segment();
-    fxs[seg_id].from = from;
-    fxs[seg_id].to = to;
-    fxs[seg_id].cursor = from;
-    fxs[seg_id].start  = ((from <= to) ? from : to);
-    fxs[seg_id].end    = ((from >  to) ? from : to);
-    fxs[seg_id].dir    = ((from <= to) ? 1    : -1);
-    fxs[seg_id].mode = mode;
+    FX_t *FX = get_available_effect();
+    if (!FX) return NULL;
+    FX->from = from;
+    FX->to = to;
+    FX->cursor = from;
+    FX->start  = ((from <= to) ? from : to);
+    FX->end    = ((from >  to) ? from : to);
+    FX->dir    = ((from <= to) ? 1    : -1);
+    FX->mode = mode;
     for(uint16_t i=0; i<8; i++) {
-        fxs[seg_id].colors[i] = colors[i];
-    }
-    fxs[seg_id].param = param;
-    fxs[seg_id].loops = loops;
-    fxs[seg_id].loop_counter = 0;
-    fxs[seg_id].step_ms = config.animation_step_ms;
-    fxs[seg_id].callback = noop;
-    fxs[seg_id].running = true;
-    fxs[seg_id].ending = false;
-    fxs[seg_id].canceled = false;
-    fxs[seg_id].clear_on_end = true;
+        FX->colors[i] = colors[i];
+    }
+    FX->param = param;
+    FX->loops = loops;
+    FX->loop_counter = 0;
+    FX->step_ms = config.animation_step_ms;
+    FX->callback = noop;
+    FX->ending = false;
+    FX->last_pixel = 0xffff;
+    FX->clear_on_end = true;
 
     switch(mode) {
         case FX_SCAN:
-            fxs[seg_id].fx_function = fx_scan;
+            FX->fx_function = fx_scan;
             break;
         case FX_WIPE:
-            fxs[seg_id].fx_function = fx_wipe;
-            fxs[seg_id].clear_on_end = false;
+            FX->fx_function = fx_wipe;
+            FX->clear_on_end = false;
             break;
         case FX_CHASER:
-            fxs[seg_id].fx_function = fx_chaser;
+            FX->fx_function = fx_chaser;
             break;
         case FX_BLINK:
-            fxs[seg_id].start = 0;
-            fxs[seg_id].end = (param ? param - 1 : 3); // 0 to 3 is 4 blinks as a default value
-            fxs[seg_id].dir = 1; // Override
-            fxs[seg_id].cursor = 0; // Override
-            fxs[seg_id].fx_function = fx_blink;
+            FX->start = 0;
+            FX->end = (param ? param - 1 : 3); // 0 to 3 is 4 blinks as a default value
+            FX->dir = 1; // Override
+            FX->cursor = 0; // Override
+            FX->fx_function = fx_blink;
             break;
         case FX_RANDOM:
             init_random();
-            fxs[seg_id].start = 0;
-            fxs[seg_id].end = (param ? param - 1 : 3); // 0 to 3 is 4 blinks as a default value
-            fxs[seg_id].dir = 1; // Override
-            fxs[seg_id].cursor = 0; // Override
-            fxs[seg_id].fx_function = fx_random;
-            fxs[seg_id].clear_on_end = false;
+            FX->start = 0;
+            FX->end = (param ? param - 1 : 3); // 0 to 3 is 4 blinks as a default value
+            FX->dir = 1; // Override
+            FX->cursor = 0; // Override
+            FX->fx_function = fx_random;
+            FX->clear_on_end = false;
             break;
         case FX_FADE:
-            fxs[seg_id].start = 0;
-            fxs[seg_id].end = 100;
-            fxs[seg_id].cursor = ((from <= to) ? 0 : 100);
-            fxs[seg_id].fx_function = fx_fade;
-            fxs[seg_id].clear_on_end = false;
+            FX->start = 0;
+            FX->end = 100;
+            FX->cursor = ((from <= to) ? 0 : 100);
+            FX->fx_function = fx_fade;
+            FX->clear_on_end = false;
             break;
     }
-    if(animation_timers[seg_id]) cancel_alarm(animation_timers[seg_id]);
-    animation_timers[seg_id] = add_alarm_in_ms(config.animation_step_ms, animation_step, &fxs[seg_id], false);
-    return &fxs[seg_id];
+    return start_effect(FX, animation_step, config.animation_step_ms);
 }
 
 /**
@@ -863,6 +2002,18 @@ void ws2812b_cancel(FX_t* FX){
     FX->canceled = true;
 }
 
+/**
+ * @brief Set how the layer of an effect is blended into the frame
+ * @param FX Effect descriptor
+ * @param blend Blend mode
+ * @param opacity Opacity of the layer (0-255)
+ */
+void ws2812b_set_blend(FX_t *FX, FX_blend_t blend, uint8_t opacity) {
+    FX->blend = blend;
+    FX->opacity = opacity;
+    request_frame();
+}
+
 void invert_matrix_vertical(uint8_t* matrix, int rows, int cols) {
     for (int i = 0; i < rows / 2; i++) {
         for (int j = 0; j < cols; j++) {
@@ -7,9 +7,14 @@
 #ifndef WS2812B_H
 #define WS2812B_H
 
+#ifdef WS2812B_HOST
+#include "ws2812b_host.h"
+#else
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "ws2812.pio.h"
+#endif
+#include "utf-8.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,9 +38,41 @@ extern "C" {
  */
 #define WS2812B_DELAY_US 300
 
+/**
+ * @def WS2812B_PIXEL_US
+ * @brief Time in microseconds to shift out one 24-bit pixel.
+ */
+#define WS2812B_PIXEL_US (24 * 1000000 / WS2812B_FREQ_HZ)
+
+/**
+ * @def WS2812B_CHANNEL_MA
+ * @brief Current drawn by one color channel of a pixel at full level, in mA.
+ */
+#define WS2812B_CHANNEL_MA 20
+
+/**
+ * @def WS2812B_IDLE_MA
+ * @brief Current drawn by a dark pixel, in mA.
+ */
+#define WS2812B_IDLE_MA 1
+
+/**
+ * @def WS2812B_MAX_STRIPS
+ * @brief Maximum number of strips driven in parallel, see ws2812b_init_parallel.
+ */
+#define WS2812B_MAX_STRIPS 8
+
+/**
+ * @def WS2812B_PIXEL_LEVELS
+ * @brief Number of per-pixel brightness levels with their own lookup table,
+ * 512 bytes of 16-bit entries plus 256 rounded ones each. Pixels at further
+ * levels are scaled with a multiply, see ws2812b_set_pixel_brightness.
+ */
+#define WS2812B_PIXEL_LEVELS 4
+
 /**
  * @def MAX_EFFECTS
- * @brief Maximum number of simultaneous sections with independent effects.
+ * @brief Default number of simultaneous effects, see ws2812b_init_ex.
  */
 #define MAX_EFFECTS 4
 
@@ -45,6 +82,62 @@ extern "C" {
  */
 typedef uint32_t uGRB32_t;
 
+/**
+ * @def WS2812B_SHEET_4BIT
+ * @brief Sheet flag, palette indices are 4-bit, two per byte with the low nibble first.
+ */
+#define WS2812B_SHEET_4BIT 0x01
+
+/**
+ * @def WS2812B_FRAME_DELTA
+ * @brief Frame flag, pixels with the last palette index (0x0f or 0xff) keep the previous frame.
+ */
+#define WS2812B_FRAME_DELTA 0x01
+
+/**
+ * @def WS2812B_FRAME_RLE
+ * @brief Frame flag, indices are stored as runs, (length-1, index) in one 4-bit byte or two 8-bit bytes.
+ */
+#define WS2812B_FRAME_RLE 0x02
+
+/**
+ * @struct ws2812b_sheet_t
+ * @brief Palette-indexed spritesheet, written by tools/img2grb.py -s.
+ * Every frame starts with its WS2812B_FRAME_* flags, followed by the indices
+ * of its pixels. The first frame is never a delta frame.
+ */
+typedef struct ws2812b_sheet_t {
+    /**
+     * @brief Number of frames.
+     */
+    uint8_t frames;
+
+    /**
+     * @brief Number of pixels in a frame, row by row, 8 per row like the sprites.
+     */
+    uint16_t pixels;
+
+    /**
+     * @brief WS2812B_SHEET_* flags.
+     */
+    uint8_t flags;
+
+    /**
+     * @brief Colors of the indices.
+     */
+    const uGRB32_t *palette;
+
+    /**
+     * @brief Start of each frame in data.
+     */
+    const uint16_t *offsets;
+
+    /**
+     * @brief Encoded frames.
+     */
+    const uint8_t *data;
+} ws2812b_sheet_t;
+
 /**
  * @enum FX_mode_t
  * @brief Enumerated type for different animation modes.
@@ -58,6 +151,57 @@ typedef enum {
     FX_FADE         = 5,
 } FX_mode_t;
 
+/**
+ * @enum FX_blend_t
+ * @brief Enumerated type for the ways an effect layer is blended into the frame.
+ */
+typedef enum {
+    FX_BLEND_REPLACE = 0,   // Drawn pixels replace the frame
+    FX_BLEND_ADD     = 1,   // Drawn pixels are added to the frame, saturating
+    FX_BLEND_ALPHA   = 2,   // Drawn pixels are mixed with the frame by opacity
+} FX_blend_t;
+
+/**
+ * @def WS2812B_MATRIX_SERPENTINE
+ * @brief Matrix layout flag, every other row of pixels runs the opposite way.
+ */
+#define WS2812B_MATRIX_SERPENTINE    0x01
+
+/**
+ * @def WS2812B_MATRIX_BOTTOM_UP
+ * @brief Matrix layout flag, the first pixel is on the bottom row.
+ */
+#define WS2812B_MATRIX_BOTTOM_UP     0x02
+
+/**
+ * @def WS2812B_MATRIX_RIGHT_TO_LEFT
+ * @brief Matrix layout flag, the first row of pixels runs from right to left.
+ */
+#define WS2812B_MATRIX_RIGHT_TO_LEFT 0x04
+
+/**
+ * @def WS2812B_MATRIX_BITDOGLAB
+ * @brief Layout of the BitDogLab 5x5 matrix.
+ */
+#define WS2812B_MATRIX_BITDOGLAB (WS2812B_MATRIX_SERPENTINE | WS2812B_MATRIX_BOTTOM_UP | WS2812B_MATRIX_RIGHT_TO_LEFT)
+
+/**
+ * @def WS2812B_NO_PIXEL
+ * @brief Pixel index of coordinates outside the matrix.
+ */
+#define WS2812B_NO_PIXEL 0xffff
+
+/**
+ * @enum ws2812b_rotation_t
+ * @brief Clockwise rotation of the image on a matrix.
+ */
+typedef enum {
+    WS2812B_ROTATE_0   = 0,
+    WS2812B_ROTATE_90  = 1,
+    WS2812B_ROTATE_180 = 2,
+    WS2812B_ROTATE_270 = 3
+} ws2812b_rotation_t;
+
 /**
  * @struct FX_t
  * @brief Structure representing an animation effect.
@@ -164,19 +308,74 @@ typedef struct FX_t {
     uint32_t gap_ms;
 
     /**
-     * @brief Buffer cursor for the animation effect (only applicable for text-based effects).
+     * @brief Spritesheet for the animation effect (only applicable for sequence-based effects).
      */
-    uint8_t buf_crs;
+    const uGRB32_t **spritesheet;
 
     /**
-     * @brief Spritesheet for the animation effect (only applicable for sequence-based effects).
+     * @brief Palette-indexed spritesheet, used instead of spritesheet when set (only applicable for sequence-based effects).
      */
-    const uGRB32_t **spritesheet;
+    const ws2812b_sheet_t *sheet;
 
     /**
      * @brief Number of frames for the animation effect (only applicable for sequence-based effects).
      */
     uint8_t frames;
+
+    /**
+     * @brief Function drawing a step, returning the time until the next one in microseconds.
+     */
+    int64_t (*step_function)(struct FX_t *FX);
+
+    /**
+     * @brief Time of the next step in microseconds.
+     */
+    uint64_t due_us;
+
+    /**
+     * @brief Layer the effect draws into, with the alpha in the high byte.
+     */
+    uGRB32_t *layer;
+
+    /**
+     * @brief Blend mode of the layer.
+     */
+    FX_blend_t blend;
+
+    /**
+     * @brief Opacity of the layer (0-255).
+     */
+    uint8_t opacity;
+
+    /**
+     * @brief UTF-8 iterator (only applicable for text-based effects).
+     */
+    utf8_iter iter;
+
+    /**
+     * @brief Decoded text, one byte per column with the top row in bit 0 (only applicable for scrolling text).
+     */
+    uint8_t *text_columns;
+
+    /**
+     * @brief Number of columns in text_columns, blank padding included (only applicable for scrolling text).
+     */
+    uint16_t text_width;
+
+    /**
+     * @brief Allocated size of text_columns, kept for the next text (only applicable for scrolling text).
+     */
+    uint16_t text_capacity;
+
+    /**
+     * @brief Flag indicating whether the gap between characters is shown (only applicable for typed text).
+     */
+    bool is_gap;
+
+    /**
+     * @brief Pixel drawn on the previous step (only applicable for FX_SCAN).
+     */
+    uint16_t last_pixel;
 } FX_t;
 
 /**
@@ -195,15 +394,30 @@ struct ws2812b_config {
     uint pio_sm;
 
     /**
-     * @brief Number of pixels in the LED strip.
+     * @brief Number of pixels in the LED strip, of all the strips in parallel mode.
      */
     uint16_t num_pixels;
 
+    /**
+     * @brief Number of strips driven in parallel, 1 for a single strip.
+     */
+    uint8_t num_strips;
+
+    /**
+     * @brief Number of pixels in each strip.
+     */
+    uint16_t strip_pixels;
+
     /**
      * @brief Animation step time in milliseconds.
      */
     uint32_t animation_step_ms;
 
+    /**
+     * @brief Minimum time between two frames in microseconds.
+     */
+    uint32_t frame_interval_us;
+
     /**
      * @brief Flag indicating whether the random number generator has been seeded.
      */
@@ -220,9 +434,55 @@ struct ws2812b_config {
     uint8_t *global_mask;
 
     /**
-     * @brief Global dimming value for the LED strip.
+     * @brief Global brightness (0-255) for the LED strip.
      */
-    uint8_t global_dimming;
+    uint8_t brightness;
+
+    /**
+     * @brief Flag indicating whether temporal dithering is enabled.
+     */
+    bool dithering;
+
+    /**
+     * @brief Gamma correction exponent, 1.0 for none.
+     */
+    float gamma;
+
+    /**
+     * @brief Current budget of the LEDs in mA, 0 for none.
+     */
+    uint32_t power_budget_ma;
+
+    /**
+     * @brief Width of the matrix as drawn, after rotation, 0 without a matrix.
+     */
+    uint16_t matrix_width;
+
+    /**
+     * @brief Height of the matrix as drawn, after rotation, 0 without a matrix.
+     */
+    uint16_t matrix_height;
+};
+
+/**
+ * @struct ws2812b_power_stats
+ * @brief Estimated current of the frames and how often it was limited.
+ */
+struct ws2812b_power_stats {
+    /**
+     * @brief Estimated current of the last frame sent, in mA.
+     */
+    uint32_t frame_ma;
+
+    /**
+     * @brief Estimated current of the last frame before limiting, in mA.
+     */
+    uint32_t requested_ma;
+
+    /**
+     * @brief Number of frames scaled down to the budget.
+     */
+    uint32_t limited_frames;
 };
 
 /**
@@ -250,6 +510,72 @@ uGRB32_t ws2812b_hex(uint32_t hex);
  */
 uGRB32_t ws2812b_hsv(float _h, float _s, float _v);
 
+/**
+ * @brief Create a 24-bit color from HSV values, in integer math.
+ * @param h Hue (0-65535 for a full turn).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @return 24-bit color value.
+ */
+uGRB32_t ws2812b_hsv16(uint16_t h, uint8_t s, uint8_t v);
+
+/**
+ * @brief Create a 24-bit color from 8-bit HSV values, in integer math.
+ * @param h Hue (0-255 for a full turn).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @return 24-bit color value.
+ */
+uGRB32_t ws2812b_hsv8(uint8_t h, uint8_t s, uint8_t v);
+
+/**
+ * @brief Scale an 8-bit value, 255 keeps it unchanged.
+ * @param x Value.
+ * @param scale Scale (0-255).
+ * @return Scaled value.
+ */
+static inline uint8_t ws2812b_scale8(uint8_t x, uint8_t scale) {
+    return ((uint16_t)x * (scale + 1)) >> 8;
+}
+
+/**
+ * @brief Interpolate between two 8-bit values.
+ * @param a Value at 0.
+ * @param b Value at 255.
+ * @param frac Position between the values (0-255).
+ * @return Interpolated value.
+ */
+static inline uint8_t ws2812b_lerp8(uint8_t a, uint8_t b, uint8_t frac) {
+    return (b >= a ? a + ws2812b_scale8(b - a, frac) : a - ws2812b_scale8(a - b, frac));
+}
+
+/**
+ * @brief Scale the three channels of a color.
+ * @param grb 24-bit color value.
+ * @param scale Scale (0-255).
+ * @return Scaled 24-bit color value.
+ */
+static inline uGRB32_t ws2812b_scale_color(uGRB32_t grb, uint8_t scale) {
+    uint32_t s = scale + 1;
+    // Green and blue share one multiply, red gets its own
+    uint32_t gb = (((grb & 0x00ff00ffu) * s) >> 8) & 0x00ff00ffu;
+    uint32_t r = (((grb & 0x0000ff00u) * s) >> 8) & 0x0000ff00u;
+    return gb | r;
+}
+
+/**
+ * @brief Interpolate between two colors.
+ * @param a Color at 0.
+ * @param b Color at 255.
+ * @param frac Position between the colors (0-255).
+ * @return Interpolated 24-bit color value.
+ */
+static inline uGRB32_t ws2812b_lerp_color(uGRB32_t a, uGRB32_t b, uint8_t frac) {
+    return ((uint32_t)ws2812b_lerp8(a >> 16, b >> 16, frac) << 16)
+         | ((uint32_t)ws2812b_lerp8(a >> 8, b >> 8, frac) << 8)
+         | ws2812b_lerp8(a, b, frac);
+}
+
 /**
  * @brief Create a random 24-bit color.
  * @param value Value (0.0-100.0).
@@ -266,7 +592,38 @@ uGRB32_t ws2812b_random_color(float value);
 void ws2812b_init(PIO _pio, uint8_t gpio, uint16_t num_pixels);
 
 /**
- * @brief Render the LED strip.
+ * @brief Initialize the WS2812B LED strip with an effect pool of a given size.
+ * @param _pio PIO instance.
+ * @param gpio GPIO pin.
+ * @param num_pixels Number of pixels in the LED strip.
+ * @param max_effects Number of effects that can run at the same time.
+ */
+void ws2812b_init_ex(PIO _pio, uint8_t gpio, uint16_t num_pixels, uint16_t max_effects);
+
+/**
+ * @brief Initialize up to 8 strips of the same length on consecutive GPIOs, refreshed in parallel.
+ * The strips share one buffer, strip s starting at pixel s * strip_pixels.
+ * @param _pio PIO instance.
+ * @param gpio_base GPIO pin of the first strip.
+ * @param num_strips Number of strips (1-8).
+ * @param strip_pixels Number of pixels in each strip, clamped so the strips hold at most 65535 pixels in all.
+ * @param max_effects Number of effects that can run at the same time.
+ */
+void ws2812b_init_parallel(PIO _pio, uint8_t gpio_base, uint8_t num_strips, uint16_t strip_pixels, uint16_t max_effects);
+
+/**
+ * @brief Get the buffer index of a pixel of one of the parallel strips.
+ * @param strip Strip index.
+ * @param index Pixel index within the strip.
+ * @return Pixel index for ws2812b_put, ws2812b_fill and the effects.
+ */
+uint16_t ws2812b_strip_pixel(uint8_t strip, uint16_t index);
+
+/**
+ * @brief Publish the frame drawn so far and request a render, sent from a one-shot alarm.
+ * Until the next call the renderer keeps sending the last published frame.
+ * What a stopped effect showed last is written into the drawing before the
+ * next drawing call or ws2812b_render, so it stays on the strip.
  */
 void ws2812b_render();
 
@@ -296,12 +653,74 @@ void ws2812b_fill(uint32_t from, uint32_t to, uGRB32_t grb);
  */
 void ws2812b_fill_all(uGRB32_t grb);
 
+/**
+ * @brief Lay the pixels out as a matrix, for the drawing functions taking coordinates.
+ * @param width Width of the matrix in pixels, before rotation.
+ * @param height Height of the matrix in pixels, before rotation.
+ * @param layout WS2812B_MATRIX_* flags describing the wiring.
+ * @param rotation Rotation of the image on the matrix.
+ * @return False if the matrix has more pixels than the strip or memory ran out.
+ */
+bool ws2812b_matrix_init(uint16_t width, uint16_t height, uint8_t layout, ws2812b_rotation_t rotation);
+
+/**
+ * @brief Get the pixel index at a point of the matrix.
+ * @param x Column, 0 on the left.
+ * @param y Row, 0 on the top.
+ * @return Pixel index, WS2812B_NO_PIXEL outside the matrix.
+ */
+uint16_t ws2812b_matrix_index(int32_t x, int32_t y);
+
+/**
+ * @brief Set the color of a pixel of the matrix, points outside are ignored.
+ * @param x Column.
+ * @param y Row.
+ * @param grb 24-bit color value.
+ */
+void ws2812b_put_xy(int32_t x, int32_t y, uGRB32_t grb);
+
+/**
+ * @brief Fill a rectangle of the matrix, clipped to the matrix.
+ * @param x Left column.
+ * @param y Top row.
+ * @param w Width.
+ * @param h Height.
+ * @param grb 24-bit color value.
+ */
+void ws2812b_fill_rect(int32_t x, int32_t y, uint16_t w, uint16_t h, uGRB32_t grb);
+
+/**
+ * @brief Draw a line on the matrix, clipped to the matrix.
+ * @param x0 Start column.
+ * @param y0 Start row.
+ * @param x1 End column.
+ * @param y1 End row.
+ * @param grb 24-bit color value.
+ */
+void ws2812b_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uGRB32_t grb);
+
+/**
+ * @brief Copy an image, row by row from the top left, onto the matrix, clipped to the matrix.
+ * @param x Column of the left edge of the image.
+ * @param y Row of the top edge of the image.
+ * @param image Image data, like the sprites written by tools/img2grb.py.
+ * @param w Width of the image.
+ * @param h Height of the image.
+ */
+void ws2812b_blit(int32_t x, int32_t y, const uGRB32_t *image, uint16_t w, uint16_t h);
+
 /**
  * @brief Set the animation step time in milliseconds.
  * @param fps Frames per second.
  */
 void ws2812b_config_set_fps(uint16_t fps);
 
+/**
+ * @brief Set the maximum rate at which frames are sent to the LEDs.
+ * @param fps Frames per second.
+ */
+void ws2812b_config_set_max_fps(uint16_t fps);
+
 /**
  * @brief Set the animation step time in milliseconds for a specific effect.
  * @param FX Effect structure.
@@ -315,6 +734,12 @@ void ws2812b_set_fps(FX_t *FX, uint16_t fps);
  */
 void ws2812b_set_inverted(bool inverted);
 
+/**
+ * @brief Set the gamma correction exponent for all channels.
+ * @param gamma Exponent, 1.0 is linear.
+ */
+void ws2812b_set_gamma(float gamma);
+
 /**
  * @brief Set the background color for a specific effect.
  * @param FX Effect structure.
@@ -335,6 +760,43 @@ void ws2812b_set_callback(FX_t* FX, void (*callback)(void *user_data));
  */
 void ws2812b_set_global_dimming(uint8_t dim);
 
+/**
+ * @brief Set the global brightness for the LED strip.
+ * @param level Brightness (0-255).
+ */
+void ws2812b_set_brightness(uint8_t level);
+
+/**
+ * @brief Set the brightness of a single pixel, on top of the global one.
+ * All 256 levels can be used at once. The first WS2812B_PIXEL_LEVELS levels
+ * below 255 in use get a lookup table; pixels at other levels are scaled with
+ * a multiply per channel when rendered, to the same result but slower.
+ * @param pixel Pixel index.
+ * @param level Brightness (0-255).
+ * @return True if the level has a lookup table, false if the pixel is scaled by a multiply.
+ */
+bool ws2812b_set_pixel_brightness(uint16_t pixel, uint8_t level);
+
+/**
+ * @brief Enable or disable temporal dithering.
+ * @param enabled Dithering flag.
+ */
+void ws2812b_set_dithering(bool enabled);
+
+/**
+ * @brief Limit the estimated current of the LEDs, scaling down brighter frames.
+ * @param milliamps Budget in mA, 0 to disable the limit.
+ */
+void ws2812b_set_power_budget(uint32_t milliamps);
+
+/**
+ * @brief Get the estimated current of the frames and the number of limited frames.
+ * Without a power budget the estimate is computed here from the last frame
+ * sent rather than by the renderer on every frame.
+ * @return Power statistics.
+ */
+const struct ws2812b_power_stats* ws2812b_get_power_stats();
+
 /**
  * @brief Set the global mask for the LED strip.
  * @param mask Mask value.
@@ -348,13 +810,15 @@ void ws2812b_clear_mask();
 
 /**
  * @brief Display a sprite on the LED strip.
- * @param sprite Sprite data.
+ * With a matrix set up the sprite is drawn at its top left, clipped to the matrix.
+ * @param sprite 8x8 sprite data.
  */
 void ws2812b_sprite(const uGRB32_t *sprite);
 
 /**
  * @brief Display a tinted sprite on the LED strip.
- * @param sprite Sprite data.
+ * With a matrix set up the sprite is drawn at its top left, clipped to the matrix.
+ * @param sprite 8x8 sprite data.
  * @param grb 24-bit color value.
  */
 void ws2812b_sprite_tint(const uGRB32_t *sprite, uGRB32_t grb);
@@ -370,6 +834,15 @@ void ws2812b_sprite_tint(const uGRB32_t *sprite, uGRB32_t grb);
 FX_t* ws2812b_spritesheet(const uGRB32_t **spritesheet, uint8_t frames,
                     uint16_t delay, uint32_t loops);
 
+/**
+ * @brief Create a spritesheet effect from a palette-indexed spritesheet.
+ * @param sheet Spritesheet written by tools/img2grb.py -s.
+ * @param delay Delay between frames in milliseconds.
+ * @param loops Number of loops.
+ * @return Effect structure.
+ */
+FX_t* ws2812b_spritesheet_packed(const ws2812b_sheet_t *sheet, uint16_t delay, uint32_t loops);
+
 /**
  * @brief Create an animation effect.
  * @param from Start pixel index.
@@ -389,6 +862,14 @@ FX_t* ws2812b_animate(uint32_t from, uint32_t to, FX_mode_t mode,
  */
 void ws2812b_cancel(FX_t* FX);
 
+/**
+ * @brief Set how the layer of an effect is blended into the frame.
+ * @param FX Effect structure.
+ * @param blend Blend mode.
+ * @param opacity Opacity of the layer.
+ */
+void ws2812b_set_blend(FX_t *FX, FX_blend_t blend, uint8_t opacity);
+
 /**
  * @brief Create a text typing effect.
  * @param str Text string.
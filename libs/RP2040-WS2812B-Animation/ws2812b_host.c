@@ -0,0 +1,232 @@
+/**
+ * @file ws2812b_host.c
+ * @brief Stand-ins for the Pico SDK functions used by the library, to build and run it on a PC.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ws2812b_host.h"
+
+/**
+ * @def HOST_ALARMS
+ * @brief Number of alarms that can be pending at the same time, like the default SDK alarm pool.
+ */
+#define HOST_ALARMS 16
+
+/**
+ * @brief Pending alarm.
+ */
+typedef struct {
+    alarm_id_t id;          /**< 0 when the slot is free */
+    uint64_t due_us;
+    alarm_callback_t callback;
+    void *user_data;
+} host_alarm_t;
+
+static pio_hw_t pio_instances[2];
+PIO pio0 = &pio_instances[0], pio1 = &pio_instances[1];
+const pio_program_t ws2812_program, ws2812_parallel_program;
+
+static uint64_t now_us;
+static host_alarm_t alarms[HOST_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+static spin_lock_t spin_locks[32];
+
+static irq_handler_t dma_handler;
+static bool dma_irq_enabled;
+static bool dma_irq_pending;
+static uint32_t *frame;
+static uint32_t frame_words;
+static uint32_t frame_capacity;
+static uint32_t frame_count;
+
+/* Time and alarms */
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    for(uint32_t i=0; i<HOST_ALARMS; i++) {
+        if(alarms[i].id) continue;
+        alarms[i].id = next_alarm_id++;
+        alarms[i].due_us = now_us + us;
+        alarms[i].callback = callback;
+        alarms[i].user_data = user_data;
+        return alarms[i].id;
+    }
+    return -1;
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    for(uint32_t i=0; i<HOST_ALARMS; i++) {
+        if(alarms[i].id == id) {
+            alarms[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Fire the earliest alarm due by a given time.
+ * Like the SDK, a positive return value reschedules the alarm from now and a
+ * negative one from the time it was due.
+ * @param end_us Simulated time to run to
+ * @return False if no alarm is due
+ */
+static bool fire_next_alarm(uint64_t end_us) {
+    host_alarm_t *next = NULL;
+    for(uint32_t i=0; i<HOST_ALARMS; i++) {
+        if(alarms[i].id && alarms[i].due_us <= end_us && (!next || alarms[i].due_us < next->due_us)) {
+            next = &alarms[i];
+        }
+    }
+    if(!next) return false;
+
+    host_alarm_t fired = *next;
+    // The slot stays taken during the callback, so a new alarm gets another one
+    next->due_us = UINT64_MAX;
+    if(fired.due_us > now_us) now_us = fired.due_us;
+    int64_t delay_us = fired.callback(fired.id, fired.user_data);
+    if(next->id != fired.id) return true; // Canceled from the callback
+    if(delay_us > 0) {
+        next->due_us = now_us + delay_us;
+    } else if(delay_us < 0) {
+        next->due_us = fired.due_us - delay_us;
+    } else {
+        next->id = 0;
+    }
+    return true;
+}
+
+void ws2812b_host_run(uint64_t us) {
+    uint64_t end_us = now_us + us;
+    for(;;) {
+        if(dma_irq_pending && dma_irq_enabled && dma_handler) {
+            dma_handler();
+            continue;
+        }
+        if(!fire_next_alarm(end_us)) break;
+    }
+    now_us = end_us;
+}
+
+/* Interrupts and spinlocks, there is a single thread of execution */
+
+uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+void restore_interrupts(uint32_t status) {
+}
+
+uint spin_lock_claim_unused(bool required) {
+    return 0;
+}
+
+spin_lock_t *spin_lock_init(uint lock_num) {
+    return &spin_locks[lock_num];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    return 0;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) {
+}
+
+/* PIO, the words are sent straight away */
+
+uint pio_claim_unused_sm(PIO pio, bool required) {
+    return 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    return 0;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return 0;
+}
+
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm) {
+    return 0;
+}
+
+void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, float freq, bool rgbw) {
+}
+
+void ws2812_parallel_program_init(PIO pio, uint sm, uint offset, uint pin_base, uint pin_count, float freq) {
+}
+
+/* DMA, a transfer completes at once and raises DMA_IRQ_0 */
+
+int dma_claim_unused_channel(bool required) {
+    return 0;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {0};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *c, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    if(!transfer_count) return;
+    if(transfer_count > frame_capacity) {
+        uint32_t *grown = realloc(frame, transfer_count * sizeof(uint32_t));
+        if(!grown) return;
+        frame = grown;
+        frame_capacity = transfer_count;
+    }
+    memcpy(frame, (const void *)read_addr, transfer_count * sizeof(uint32_t));
+    frame_words = transfer_count;
+    frame_count++;
+    dma_irq_pending = true;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_irq_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return dma_irq_pending;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_irq_pending = false;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    dma_handler = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+}
+
+/* Captured frames */
+
+const uint32_t *ws2812b_host_frame(uint32_t *words) {
+    if(words) *words = frame_words;
+    return frame_count ? frame : NULL;
+}
+
+uint32_t ws2812b_host_frame_count(void) {
+    return frame_count;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ws2812b_host.h
+ * @brief Stand-ins for the Pico SDK functions used by the library, to build and run it on a PC.
+ * @details With WS2812B_HOST defined the library includes this header instead of the SDK.
+ * Time is simulated: alarms only fire from ws2812b_host_run, and the frames sent
+ * by DMA are kept for ws2812b_host_frame instead of reaching a PIO.
+ */
+
+#ifndef WS2812B_HOST_H
+#define WS2812B_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+typedef volatile uint32_t spin_lock_t;
+typedef void (*irq_handler_t)(void);
+
+typedef struct pio_hw {
+    volatile uint32_t txf[4];
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+typedef struct {
+    uint8_t length;
+} pio_program_t;
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+#define DMA_IRQ_0 11
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+extern PIO pio0, pio1;
+extern const pio_program_t ws2812_program, ws2812_parallel_program;
+
+uint64_t time_us_64(void);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+uint spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_init(uint lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+uint pio_claim_unused_sm(PIO pio, bool required);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm);
+void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, float freq, bool rgbw);
+void ws2812_parallel_program_init(PIO pio, uint sm, uint offset, uint pin_base, uint pin_count, float freq);
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void dma_channel_configure(uint channel, const dma_channel_config *c, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_set_enabled(uint num, bool enabled);
+
+/**
+ * @brief Advance the simulated clock, firing the alarms and DMA interrupts due meanwhile.
+ * @param us Time to advance in microseconds.
+ */
+void ws2812b_host_run(uint64_t us);
+
+/**
+ * @brief Get the last frame sent by DMA.
+ * @param words Set to the number of words of the frame, may be NULL.
+ * @return Words shifted out to the PIO, NULL before the first frame.
+ */
+const uint32_t *ws2812b_host_frame(uint32_t *words);
+
+/**
+ * @brief Get the number of frames sent by DMA so far.
+ * @return Number of frames.
+ */
+uint32_t ws2812b_host_frame_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
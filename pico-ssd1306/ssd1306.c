@@ -23,9 +23,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#ifndef SSD1306_HOST
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
 #include <pico/binary_info.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -39,41 +41,42 @@ inline static void swap(int32_t *a, int32_t *b) {
     *b=*t;
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
-    case PICO_ERROR_GENERIC:
-        printf("[%s] addr not acknowledged!\n", name);
-        break;
-    case PICO_ERROR_TIMEOUT:
-        printf("[%s] timeout!\n", name);
-        break;
-    default:
-        //printf("[%s] wrote successfully %lu bytes!\n", name, len);
-        break;
-    }
+inline static void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len) {
+    p->transport->write_cmds(p->transport_ctx, cmds, len);
 }
 
 inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
-    uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+    ssd1306_write_cmds(p, &val, 1);
 }
 
+#ifndef SSD1306_HOST
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
+    ssd1306_i2c_setup(&p->i2c, i2c_instance, address);
+
+    return ssd1306_init_with_transport(p, width, height, &ssd1306_transport_i2c, &p->i2c);
+}
+#endif
+
+bool ssd1306_init_with_transport(ssd1306_t *p, uint16_t width, uint16_t height, const ssd1306_transport_t *transport, void *ctx) {
     p->width=width;
     p->height=height;
     p->pages=height/8;
-    p->address=address;
-
-    p->i2c_i=i2c_instance;
 
+    p->transport=transport;
+    p->transport_ctx=ctx;
 
+#ifdef SSD1306_FIXED_WIDTH
+    if(width!=SSD1306_FIXED_WIDTH || height!=SSD1306_FIXED_HEIGHT)
+        return false;
+    p->bufsize=sizeof(p->framebuffer);
+    p->buffer=p->framebuffer;
+#else
     p->bufsize=(p->pages)*(p->width);
-    if((p->buffer=malloc(p->bufsize+1))==NULL) {
+    if((p->buffer=malloc(p->bufsize))==NULL) {
         p->bufsize=0;
         return false;
     }
-
-    ++(p->buffer);
+#endif
 
     // from https://github.com/makerportal/rpi-pico-ssd1306
     uint8_t cmds[]= {
@@ -109,14 +112,18 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         0x00,  // horizontal
     };
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 
     return true;
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
-    free(p->buffer-1);
+    if(p->transport->deinit)
+        p->transport->deinit(p->transport_ctx);
+
+#ifndef SSD1306_FIXED_WIDTH
+    free(p->buffer);
+#endif
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
@@ -128,28 +135,140 @@ inline void ssd1306_poweron(ssd1306_t *p) {
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    uint8_t cmds[]= {SET_CONTRAST, val};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
     ssd1306_write(p, SET_NORM_INV | (inv & 1));
 }
 
+/*
+ * word-at-a-time kernels: buffers are walked 32 bits at a time where the
+ * pointers are 4 byte aligned, unaligned heads and tails a byte at a time.
+ */
+static inline bool ssd1306_aligned(const void *a, const void *b) {
+    return !(((uintptr_t) a|(uintptr_t) b)&3);
+}
+
+// x=(x&keep)^flip for n bytes, which sets, clears or inverts the bits of a mask
+static void ssd1306_mask_span(uint8_t *b, uint32_t n, uint8_t keep, uint8_t flip) {
+    for(; n && ((uintptr_t) b&3); --n, ++b)
+        *b=(*b&keep)^flip;
+
+    const uint32_t keep_w=keep*0x01010101u, flip_w=flip*0x01010101u;
+    uint32_t *w=(uint32_t *) b;
+    for(; n>=4; n-=4, ++w)
+        *w=(*w&keep_w)^flip_w;
+
+    for(b=(uint8_t *) w; n; --n, ++b)
+        *b=(*b&keep)^flip;
+}
+
+void ssd1306_fill_pattern(ssd1306_t *p, uint32_t pattern) {
+    uint8_t *b=ssd1306_buffer(p);
+    const size_t n=ssd1306_bufsize(p);
+
+    if(((uintptr_t) b&3) || (n&3)) {
+        for(size_t i=0; i<n; ++i)
+            b[i]=pattern>>(8*(i&3));
+        return;
+    }
+
+    uint32_t *w=(uint32_t *) b;
+    for(size_t i=0; i<n>>2; ++i)
+        w[i]=pattern;
+}
+
 inline void ssd1306_clear(ssd1306_t *p) {
-    memset(p->buffer, 0, p->bufsize);
+    ssd1306_fill_pattern(p, 0);
+}
+
+void ssd1306_combine(ssd1306_t *p, const uint8_t *src, ssd1306_combine_op_t op) {
+    uint8_t *b=ssd1306_buffer(p);
+    const size_t n=ssd1306_bufsize(p);
+    size_t i=0;
+
+    if(ssd1306_aligned(b, src)) {
+        uint32_t *dw=(uint32_t *) b;
+        const uint32_t *sw=(const uint32_t *) src;
+        if(op==SSD1306_COMBINE_OR) {
+            for(; i<n>>2; ++i)
+                dw[i]|=sw[i];
+        } else {
+            for(; i<n>>2; ++i)
+                dw[i]^=sw[i];
+        }
+        i<<=2;
+    }
+
+    for(; i<n; ++i)
+        b[i]=op==SSD1306_COMBINE_OR?b[i]|src[i]:b[i]^src[i];
+}
+
+// first differing byte of a and b, n if equal
+static uint32_t ssd1306_first_diff(const uint8_t *a, const uint8_t *b, uint32_t n) {
+    uint32_t i=0;
+    for(; i<n && ((uintptr_t) (a+i)&3); ++i)
+        if(a[i]!=b[i]) return i;
+
+    if(ssd1306_aligned(a+i, b+i)) {
+        for(; i+4<=n; i+=4)
+            if(*(const uint32_t *) (a+i)!=*(const uint32_t *) (b+i)) break;
+    }
+
+    for(; i<n; ++i)
+        if(a[i]!=b[i]) return i;
+    return n;
+}
+
+// last differing byte of a and b, searched down to <start> which is known to differ
+static uint32_t ssd1306_last_diff(const uint8_t *a, const uint8_t *b, uint32_t n, uint32_t start) {
+    uint32_t i=n;
+    for(; i>start && ((uintptr_t) (a+i)&3); --i)
+        if(a[i-1]!=b[i-1]) return i-1;
+
+    if(ssd1306_aligned(a+i, b+i)) {
+        for(; i>=start+4; i-=4)
+            if(*(const uint32_t *) (a+i-4)!=*(const uint32_t *) (b+i-4)) break;
+    }
+
+    for(; i>start; --i)
+        if(a[i-1]!=b[i-1]) return i-1;
+    return start;
+}
+
+uint32_t ssd1306_diff(ssd1306_t *p, const uint8_t *prev, uint8_t *span_start, uint8_t *span_end) {
+    const uint32_t width=ssd1306_width(p);
+    const uint8_t *b=ssd1306_buffer(p);
+    uint32_t changed=0;
+
+    for(uint32_t pg=0; pg<ssd1306_pages(p); ++pg, b+=width, prev+=width) {
+        const uint32_t first=ssd1306_first_diff(b, prev, width);
+        if(first==width) {
+            span_start[pg]=0xff;
+            span_end[pg]=0;
+            continue;
+        }
+
+        span_start[pg]=first;
+        span_end[pg]=ssd1306_last_diff(b, prev, width, first);
+        ++changed;
+    }
+
+    return changed;
 }
 
 void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
-    if(x>=p->width || y>=p->height) return;
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p)) return;
 
-    p->buffer[x+p->width*(y>>3)]&=~(0x1<<(y&0x07));
+    ssd1306_buffer(p)[x+ssd1306_width(p)*(y>>3)]&=~(0x1<<(y&0x07));
 }
 
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
-    if(x>=p->width || y>=p->height) return;
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p)) return;
 
-    p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
+    ssd1306_buffer(p)[x+ssd1306_width(p)*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
 }
 
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
@@ -174,16 +293,68 @@ void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t
     }
 }
 
+// applies x=(x&keep)^flip to the bits of a rectangle, a page row at a time
+static void ssd1306_mask_rect(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool keep_rest, bool flip) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p) || !width || !height) return;
+    if(width>ssd1306_width(p)-x) width=ssd1306_width(p)-x;
+    if(height>ssd1306_height(p)-y) height=ssd1306_height(p)-y;
+
+    const uint32_t y_end=y+height;
+    while(y<y_end) {
+        const uint32_t shift=y&7;
+        const uint32_t rows=(8-shift<y_end-y)?8-shift:y_end-y;
+        const uint8_t mask=(uint8_t) (((1u<<rows)-1)<<shift);
+
+        ssd1306_mask_span(ssd1306_buffer(p)+(y>>3)*ssd1306_width(p)+x, width, keep_rest?0xff:~mask, flip?mask:0);
+        y+=rows;
+    }
+}
+
+// sets or clears a rectangle
+static inline void ssd1306_fill_rect(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool set) {
+    ssd1306_mask_rect(p, x, y, width, height, false, set);
+}
+
+void ssd1306_scroll_region_left(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t n) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p) || !width || !height || !n) return;
+    if(width>ssd1306_width(p)-x) width=ssd1306_width(p)-x;
+    if(height>ssd1306_height(p)-y) height=ssd1306_height(p)-y;
+    if(n>=width) {
+        ssd1306_fill_rect(p, x, y, width, height, false);
+        return;
+    }
+
+    const uint32_t y_end=y+height;
+    while(y<y_end) {
+        const uint32_t shift=y&7;
+        const uint32_t rows=(8-shift<y_end-y)?8-shift:y_end-y;
+        const uint8_t mask=(uint8_t) (((1u<<rows)-1)<<shift);
+        uint8_t *b=ssd1306_buffer(p)+(y>>3)*ssd1306_width(p)+x;
+
+        if(mask==0xff) {
+            memmove(b, b+n, width-n);
+            memset(b+width-n, 0, n);
+        } else {
+            for(uint32_t i=0; i<width-n; ++i)
+                b[i]=(b[i]&~mask)|(b[i+n]&mask);
+            for(uint32_t i=width-n; i<width; ++i)
+                b[i]&=~mask;
+        }
+
+        y+=rows;
+    }
+}
+
 void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_clear_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, x, y, width, height, false);
 }
 
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_draw_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, x, y, width, height, true);
+}
+
+void ssd1306_invert_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    ssd1306_mask_rect(p, x, y, width, height, true, true);
 }
 
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -193,11 +364,131 @@ void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t wi
     ssd1306_draw_line(p, x+width, y, x+width, y+height);
 }
 
-void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+/*
+ * glyph cache for scaled text
+ *
+ * a scaled glyph is stored as parts_per_line*scale page rows of
+ * (font[1]+font[2])*scale bytes each, the spacing included: every source byte
+ * (8 rows) expands to <scale> bytes and every source column is repeated
+ * <scale> times, so a row is copied in one go.
+ */
+#ifndef SSD1306_GLYPH_CACHE_ENTRIES
+#define SSD1306_GLYPH_CACHE_ENTRIES 16 // must be a power of two
+#endif
+
+#ifndef SSD1306_GLYPH_CACHE_SLOT_SIZE
+#define SSD1306_GLYPH_CACHE_SLOT_SIZE 128
+#endif
+
+typedef struct {
+    const uint8_t *font;
+    uint32_t scale;
+    char c;
+    uint8_t data[SSD1306_GLYPH_CACHE_SLOT_SIZE];
+} ssd1306_glyph_cache_entry_t;
+
+static ssd1306_glyph_cache_entry_t glyph_cache[SSD1306_GLYPH_CACHE_ENTRIES];
+
+/*
+ * rows that do not start on a page boundary are shifted and spill over into
+ * the next page.
+ */
+void ssd1306_blit_columns(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *src, uint32_t ncols, uint32_t col_bytes, uint32_t repeat) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p)) return;
+
+    const uint32_t page=y>>3, shift=y&7;
+    uint32_t w=ncols*repeat;
+    if(w>ssd1306_width(p)-x)
+        w=ssd1306_width(p)-x;
+
+    for(uint32_t b=0; b<col_bytes && page+b<ssd1306_pages(p); ++b) {
+        uint8_t *lo=ssd1306_buffer(p)+x+ssd1306_width(p)*(page+b);
+        uint8_t *hi=(shift && page+b+1<ssd1306_pages(p))?lo+ssd1306_width(p):NULL;
+        const uint8_t *s=src+b;
+
+        for(uint32_t i=0; i<w; s+=col_bytes) {
+            const uint8_t l=*s<<shift, h=*s>>(8-shift);
+            const uint32_t end=repeat<w-i?i+repeat:w;
+            if(hi) {
+                for(; i<end; ++i) {
+                    lo[i]|=l;
+                    hi[i]|=h;
+                }
+            } else {
+                for(; i<end; ++i)
+                    lo[i]|=l;
+            }
+        }
+    }
+}
+
+static inline uint32_t ssd1306_font_parts_per_line(const uint8_t *font) {
+    return (font[0]>>3)+((font[0]&7)>0);
+}
+
+// stretch the 8 rows of <line> to 8*scale rows, the first n of its <scale> bytes are written <stride> apart
+static void ssd1306_expand_byte(uint8_t line, uint32_t scale, uint8_t *dst, uint32_t stride, uint32_t n) {
+    if(n>scale)
+        n=scale;
+    for(uint32_t i=0; i<n; ++i)
+        dst[i*stride]=0;
+
+    for(uint32_t j=0, k=0; j<8 && (k>>3)<n; ++j, line>>=1) {
+        if(!(line&1)) {
+            k+=scale;
+            continue;
+        }
+        for(uint32_t r=0; r<scale && (k>>3)<n; ++r, ++k)
+            dst[(k>>3)*stride]|=1<<(k&7);
+    }
+}
+
+// the first <rows> page rows of the scaled glyph of c, <stride> bytes apart
+static void ssd1306_expand_glyph(const uint8_t *font, uint32_t scale, char c, uint8_t *dst, uint32_t stride, uint32_t rows) {
+    const uint32_t parts_per_line=ssd1306_font_parts_per_line(font);
+
+    for(uint32_t b=0; b<rows; ++b)
+        memset(dst+b*stride, 0, (font[1]+font[2])*scale);
+
+    const uint8_t *src=font+(c-font[3])*font[1]*parts_per_line+5;
+    for(uint32_t k=0; k<font[1]; ++k, src+=parts_per_line) {
+        for(uint32_t lp=0; lp<parts_per_line && lp*scale<rows; ++lp) {
+            uint8_t *d=dst+lp*scale*stride+k*scale;
+            const uint32_t n=rows-lp*scale;
+            ssd1306_expand_byte(src[lp], scale, d, stride, n);
+
+            // every source column is repeated <scale> times
+            for(uint32_t r=0; r<n && r<scale; ++r, d+=stride)
+                memset(d+1, *d, scale-1);
+        }
+    }
+}
+
+static inline bool ssd1306_glyph_cacheable(const uint8_t *font, uint32_t scale) {
+    return (font[1]+font[2])*ssd1306_font_parts_per_line(font)*scale*scale<=SSD1306_GLYPH_CACHE_SLOT_SIZE;
+}
+
+static const uint8_t *ssd1306_scaled_glyph(const uint8_t *font, uint32_t scale, char c) {
+    // c>>5 folds the case bit in, so 'o' and 'O' do not evict each other
+    ssd1306_glyph_cache_entry_t *e=&glyph_cache[(((uint8_t) c^((uint8_t) c>>5))+scale*5)&(SSD1306_GLYPH_CACHE_ENTRIES-1)];
+    if(e->font==font && e->scale==scale && e->c==c)
+        return e->data;
+
+    ssd1306_expand_glyph(font, scale, c, e->data, (font[1]+font[2])*scale, ssd1306_font_parts_per_line(font)*scale);
+
+    e->font=font;
+    e->scale=scale;
+    e->c=c;
+
+    return e->data;
+}
+
+// glyphs too wide for text_line are drawn square by square
+static void ssd1306_draw_char_squares(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
     if(c<font[3]||c>font[4])
         return;
 
-    uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
+    const uint32_t parts_per_line=ssd1306_font_parts_per_line(font);
     for(uint8_t w=0; w<font[1]; ++w) { // width
         uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
         for(uint32_t lp=0; lp<parts_per_line; ++lp) {
@@ -213,10 +504,216 @@ void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t
     }
 }
 
+/*
+ * scale 1 text: the glyph columns of a whole string are ORed in page by page,
+ * so the page pointers and the clipping are worked out once per string.
+ */
+static void ssd1306_blit_text(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *font, const char *s, uint32_t len) {
+    if(y>=ssd1306_height(p)) return;
+
+    const uint32_t col_bytes=ssd1306_font_parts_per_line(font), advance=font[1]+font[2];
+    const uint32_t page=y>>3, shift=y&7;
+
+    for(uint32_t b=0; b<col_bytes && page+b<ssd1306_pages(p); ++b) {
+        uint8_t *lo=ssd1306_buffer(p)+ssd1306_width(p)*(page+b);
+        uint8_t *hi=(shift && page+b+1<ssd1306_pages(p))?lo+ssd1306_width(p):NULL;
+
+        uint32_t cx=x;
+        for(uint32_t i=0; i<len && cx<ssd1306_width(p); ++i, cx+=advance) {
+            if(s[i]<font[3]||s[i]>font[4])
+                continue;
+
+            const uint8_t *g=font+(s[i]-font[3])*font[1]*col_bytes+5+b;
+            uint32_t w=font[1];
+            if(w>ssd1306_width(p)-cx)
+                w=ssd1306_width(p)-cx;
+
+            if(hi) {
+                for(uint32_t k=0; k<w; ++k, g+=col_bytes) {
+                    lo[cx+k]|=*g<<shift;
+                    hi[cx+k]|=*g>>(8-shift);
+                }
+            } else {
+                for(uint32_t k=0; k<w; ++k, g+=col_bytes)
+                    lo[cx+k]|=*g<<shift;
+            }
+        }
+    }
+}
+
+/*
+ * scaled text: the cached glyph rows of a string are first copied into
+ * text_line, one row of bytes per page the text covers, with the spacing left
+ * blank. each row is then ORed into the buffer a word at a time. the line
+ * starts at the same offset from a word boundary as the buffer, so both can
+ * be walked as words.
+ */
+#ifndef SSD1306_TEXT_LINE_SIZE
+#define SSD1306_TEXT_LINE_SIZE 512
+#endif
+
+static uint32_t text_line[SSD1306_TEXT_LINE_SIZE/4];
+
+// lo|=src<<shift and hi|=src>>(8-shift) for n bytes, hi is NULL if nothing spills over
+static void ssd1306_or_shifted(uint8_t *lo, uint8_t *hi, const uint8_t *src, uint32_t n, uint32_t shift) {
+    uint32_t i=0;
+
+    if(ssd1306_aligned(lo, src) && (!hi || ssd1306_aligned(hi, src))) {
+        for(; i<n && ((uintptr_t) (src+i)&3); ++i) {
+            lo[i]|=src[i]<<shift;
+            if(hi)
+                hi[i]|=src[i]>>(8-shift);
+        }
+
+        // bits shifted across a byte boundary are masked off
+        const uint32_t lo_mask=((0xffu<<shift)&0xff)*0x01010101u, hi_mask=(0xffu>>(8-shift))*0x01010101u;
+        const uint32_t *sw=(const uint32_t *) (src+i);
+        uint32_t *lw=(uint32_t *) (lo+i);
+        if(hi) {
+            uint32_t *hw=(uint32_t *) (hi+i);
+            for(; i+4<=n; i+=4) {
+                const uint32_t v=*(sw++);
+                *(lw++)|=(v<<shift)&lo_mask;
+                *(hw++)|=(v>>(8-shift))&hi_mask;
+            }
+        } else {
+            for(; i+4<=n; i+=4)
+                *(lw++)|=(*(sw++)<<shift)&lo_mask;
+        }
+    }
+
+    for(; i<n; ++i) {
+        lo[i]|=src[i]<<shift;
+        if(hi)
+            hi[i]|=src[i]>>(8-shift);
+    }
+}
+
+static void ssd1306_blit_scaled_text(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s, uint32_t len) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p)) return;
+
+    const uint32_t col_bytes=ssd1306_font_parts_per_line(font)*scale, advance=(font[1]+font[2])*scale;
+    const uint32_t page=y>>3, shift=y&7;
+    const uint32_t rows=col_bytes<ssd1306_pages(p)-page?col_bytes:ssd1306_pages(p)-page;
+
+    // characters past the right edge are not drawn
+    if(len>(ssd1306_width(p)-x+advance-1)/advance)
+        len=(ssd1306_width(p)-x+advance-1)/advance;
+
+    // characters per pass, a row of text_line holds up to 6 bytes of alignment padding
+    const uint32_t room=SSD1306_TEXT_LINE_SIZE/rows, per_pass=room>6?(room-6)/advance:0;
+
+    if(!per_pass) {
+        for(uint32_t i=0; i<len; ++i, x+=advance)
+            ssd1306_draw_char_squares(p, x, y, scale, font, s[i]);
+        return;
+    }
+
+    // glyphs too large for the cache are expanded straight into the line
+    const bool cached=ssd1306_glyph_cacheable(font, scale);
+
+    uint8_t *line=(uint8_t *) text_line;
+    for(uint32_t n; len; len-=n, s+=n, x+=n*advance) {
+        n=len<per_pass?len:per_pass;
+
+        const uint32_t pad=(uintptr_t) (ssd1306_buffer(p)+x)&3, stride=(pad+n*advance+3)&~3u;
+
+        for(uint32_t i=0; i<n; ++i) {
+            uint8_t *d=line+pad+i*advance;
+            if(s[i]<font[3]||s[i]>font[4]) {
+                for(uint32_t b=0; b<rows; ++b, d+=stride)
+                    memset(d, 0, advance);
+                continue;
+            }
+
+            if(!cached) {
+                ssd1306_expand_glyph(font, scale, s[i], d, stride, rows);
+                continue;
+            }
+
+            const uint8_t *g=ssd1306_scaled_glyph(font, scale, s[i]);
+            for(uint32_t b=0; b<rows; ++b, g+=advance, d+=stride)
+                memcpy(d, g, advance);
+        }
+
+        uint32_t w=n*advance;
+        if(w>ssd1306_width(p)-x)
+            w=ssd1306_width(p)-x;
+
+        for(uint32_t b=0; b<rows; ++b) {
+            uint8_t *lo=ssd1306_buffer(p)+x+ssd1306_width(p)*(page+b);
+            uint8_t *hi=(shift && page+b+1<ssd1306_pages(p))?lo+ssd1306_width(p):NULL;
+            ssd1306_or_shifted(lo, hi, line+b*stride+pad, w, shift);
+        }
+    }
+}
+
+void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+    if(c<font[3]||c>font[4] || x>=ssd1306_width(p) || y>=ssd1306_height(p))
+        return;
+
+    if(scale==1) {
+        const uint32_t parts_per_line=ssd1306_font_parts_per_line(font);
+        ssd1306_blit_columns(p, x, y, font+(c-font[3])*font[1]*parts_per_line+5, font[1], parts_per_line, 1);
+        return;
+    }
+
+    ssd1306_blit_scaled_text(p, x, y, scale, font, &c, 1);
+}
+
 void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s) {
-    for(int32_t x_n=x; *s; x_n+=(font[1]+font[2])*scale) {
-        ssd1306_draw_char_with_font(p, x_n, y, scale, font, *(s++));
+    if(scale==1) {
+        ssd1306_blit_text(p, x, y, font, s, strlen(s));
+        return;
     }
+
+    ssd1306_blit_scaled_text(p, x, y, scale, font, s, strlen(s));
+}
+
+static inline uint32_t ssd1306_text_width_of(const uint8_t *font, uint32_t scale, uint32_t len) {
+    return len?(len*(font[1]+font[2])-font[2])*scale:0;
+}
+
+uint32_t ssd1306_text_width(const uint8_t *font, uint32_t scale, const char *s) {
+    return ssd1306_text_width_of(font, scale, strlen(s));
+}
+
+uint32_t ssd1306_text_height(const uint8_t *font, uint32_t scale) {
+    return font[0]*scale;
+}
+
+uint32_t ssd1306_draw_string_aligned(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t scale, const uint8_t *font, const char *s, ssd1306_align_t align, uint32_t flags) {
+    const uint32_t advance=(font[1]+font[2])*scale;
+    uint32_t len=strlen(s);
+    uint32_t dots=0;
+
+    if((flags&(SSD1306_TEXT_CLIP|SSD1306_TEXT_ELLIPSIS)) && ssd1306_text_width_of(font, scale, len)>width) {
+        const uint32_t fit=(width+font[2]*scale)/advance;
+
+        if(flags&SSD1306_TEXT_ELLIPSIS) {
+            dots=fit<3?fit:3;
+            len=fit-dots;
+        } else {
+            len=fit;
+        }
+    }
+
+    const uint32_t text_width=ssd1306_text_width_of(font, scale, len+dots);
+
+    if(align==SSD1306_ALIGN_CENTER && text_width<width)
+        x+=(width-text_width)/2;
+    else if(align==SSD1306_ALIGN_RIGHT && text_width<width)
+        x+=width-text_width;
+
+    if(scale==1) {
+        ssd1306_blit_text(p, x, y, font, s, len);
+        ssd1306_blit_text(p, x+len*advance, y, font, "...", dots);
+    } else {
+        ssd1306_blit_scaled_text(p, x, y, scale, font, s, len);
+        ssd1306_blit_scaled_text(p, x+len*advance, y, scale, font, "...", dots);
+    }
+
+    return text_width;
 }
 
 void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, char c) {
@@ -290,17 +787,152 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
-void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
+/*
+ * native images (see tools/bmp2page.c)
+ *
+ * the data is already page-major, so every page row of the image lands in at
+ * most two buffer pages: a straight memcpy when it is page aligned, a masked
+ * blit otherwise. rle data is decoded one page row at a time into a stack buffer.
+ */
+typedef struct {
+    const uint8_t *src;
+    uint32_t left;	// bytes left in the current run
+    bool repeat;	// whether the current run repeats *src
+} ssd1306_rle_t;
+
+static void ssd1306_rle_read(ssd1306_rle_t *r, uint8_t *dst, uint32_t n) {
+    while(n) {
+        if(!r->left) {
+            uint8_t c=*(r->src++);
+            r->repeat=c&0x80;
+            r->left=(c&0x7f)+1;
+        }
+
+        uint32_t k=r->left<n?r->left:n;
+        if(r->repeat) {
+            memset(dst, *r->src, k);
+        } else {
+            memcpy(dst, r->src, k);
+            r->src+=k;
+        }
+
+        r->left-=k;
+        if(r->repeat && !r->left)
+            ++r->src;
+
+        dst+=k;
+        n-=k;
+    }
+}
+
+static void ssd1306_blit_page_row(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *src, uint32_t width, uint8_t mask, bool opaque) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p)) return;
+    if(width>ssd1306_width(p)-x) width=ssd1306_width(p)-x;
+
+    const uint32_t page=y>>3, shift=y&7;
+    uint8_t *lo=ssd1306_buffer(p)+page*ssd1306_width(p)+x;
+    uint8_t *hi=shift && page+1<ssd1306_pages(p)?lo+ssd1306_width(p):NULL;
+
+    if(!opaque) {
+        for(uint32_t i=0; i<width; ++i) {
+            uint8_t b=src[i]&mask;
+            lo[i]|=b<<shift;
+            if(hi) hi[i]|=b>>(8-shift);
+        }
+        return;
+    }
+
+    if(!shift && mask==0xff) {
+        memcpy(lo, src, width);
+        return;
+    }
+
+    const uint8_t lmask=mask<<shift, hmask=shift?mask>>(8-shift):0;
+    for(uint32_t i=0; i<width; ++i) {
+        lo[i]=(lo[i]&~lmask)|((src[i]<<shift)&lmask);
+        if(hi) hi[i]=(hi[i]&~hmask)|((src[i]>>(8-shift))&hmask);
+    }
+}
+
+static void ssd1306_image_blit(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img, bool opaque) {
+    if(img[0]!=SSD1306_IMG_MAGIC) return;
+
+    const uint32_t width=img[2], height=img[3], pages=(height+7)>>3;
+    const bool rle=img[1]&SSD1306_IMG_RLE;
+    ssd1306_rle_t r= {img+SSD1306_IMG_HEADER_SIZE, 0, false};
+    uint8_t row[255];
+
+    for(uint32_t pg=0; pg<pages && y+(pg<<3)<ssd1306_height(p); ++pg) {
+        const uint8_t *src=img+SSD1306_IMG_HEADER_SIZE+pg*width;
+        if(rle) {
+            ssd1306_rle_read(&r, row, width);
+            src=row;
+        }
+
+        // last page of an image whose height is not a multiple of 8
+        uint8_t mask=pg+1==pages && (height&7)?(1<<(height&7))-1:0xff;
+        ssd1306_blit_page_row(p, x, y+(pg<<3), src, width, mask, opaque);
+    }
+}
+
+void ssd1306_draw_image(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img) {
+    ssd1306_image_blit(p, x, y, img, false);
+}
+
+void ssd1306_copy_image(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img) {
+    ssd1306_image_blit(p, x, y, img, true);
+}
+
+void ssd1306_set_window_region(ssd1306_t *p, uint32_t col_start, uint32_t col_end, uint32_t page_start, uint32_t page_end) {
+    uint8_t payload[]= {SET_COL_ADDR, col_start, col_end, SET_PAGE_ADDR, page_start, page_end};
+    if(ssd1306_width(p)==64) {
         payload[1]+=32;
         payload[2]+=32;
     }
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    ssd1306_write_cmds(p, payload, sizeof(payload));
+}
+
+static inline void ssd1306_set_window(ssd1306_t *p) {
+    ssd1306_set_window_region(p, 0, ssd1306_width(p)-1, 0, ssd1306_pages(p)-1);
+}
 
-    *(p->buffer-1)=0x40;
+void ssd1306_show(ssd1306_t *p) {
+    ssd1306_set_window(p);
+
+    p->transport->write_data(p->transport_ctx, ssd1306_buffer(p), ssd1306_bufsize(p));
+}
+
+void ssd1306_show_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if(x>=ssd1306_width(p) || y>=ssd1306_height(p) || !width || !height) return;
+    if(width>ssd1306_width(p)-x) width=ssd1306_width(p)-x;
+    if(height>ssd1306_height(p)-y) height=ssd1306_height(p)-y;
+
+    const uint32_t page_start=y>>3, page_end=(y+height-1)>>3;
+    ssd1306_set_window_region(p, x, x+width-1, page_start, page_end);
+
+    // full width pages are contiguous in the buffer
+    if(width==ssd1306_width(p)) {
+        p->transport->write_data(p->transport_ctx, ssd1306_buffer(p)+page_start*ssd1306_width(p), (page_end-page_start+1)*ssd1306_width(p));
+        return;
+    }
+
+    for(uint32_t pg=page_start; pg<=page_end; ++pg)
+        p->transport->write_data(p->transport_ctx, ssd1306_buffer(p)+pg*ssd1306_width(p)+x, width);
+}
+
+void ssd1306_show_async(ssd1306_t *p) {
+    ssd1306_set_window(p);
+
+    if(!p->transport->write_data_async || !p->transport->write_data_async(p->transport_ctx, ssd1306_buffer(p), ssd1306_bufsize(p)))
+        p->transport->write_data(p->transport_ctx, ssd1306_buffer(p), ssd1306_bufsize(p));
+}
+
+bool ssd1306_busy(ssd1306_t *p) {
+    return p->transport->busy && p->transport->busy(p->transport_ctx);
+}
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+void ssd1306_wait(ssd1306_t *p) {
+    if(p->transport->wait)
+        p->transport->wait(p->transport_ctx);
 }
@@ -30,8 +30,15 @@ SOFTWARE.
 
 #ifndef _inc_ssd1306
 #define _inc_ssd1306
+#ifdef SSD1306_HOST
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#else
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
+#endif
+#include "ssd1306_transport.h"
 
 /**
 *	@brief defines commands used in ssd1306
@@ -56,6 +63,61 @@ typedef enum {
     SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+/**
+*	@brief horizontal alignment of text inside a box
+*/
+typedef enum {
+    SSD1306_ALIGN_LEFT,
+    SSD1306_ALIGN_CENTER,
+    SSD1306_ALIGN_RIGHT
+} ssd1306_align_t;
+
+/**
+*	@brief flags for ssd1306_draw_string_aligned
+*/
+typedef enum {
+    SSD1306_TEXT_CLIP = 0x01,		/**< drop characters that do not fit into the box */
+    SSD1306_TEXT_ELLIPSIS = 0x02,	/**< like SSD1306_TEXT_CLIP, but end clipped text with "..." */
+    SSD1306_TEXT_CONST = 0x04		/**< text is drawn again and again, work derived from it may be cached (see ssd1306_draw_utf8_aligned) */
+} ssd1306_text_flags_t;
+
+/**
+*	@brief header of native images: magic, flags, width, height
+*/
+#define SSD1306_IMG_MAGIC 'P'
+#define SSD1306_IMG_HEADER_SIZE 4
+
+/**
+*	@brief flags of native images
+*/
+typedef enum {
+    SSD1306_IMG_RLE = 0x01			/**< data is run-length encoded */
+} ssd1306_img_flags_t;
+
+/**
+*	@brief how ssd1306_combine merges a buffer into the display buffer
+*/
+typedef enum {
+    SSD1306_COMBINE_OR,				/**< set pixels of the source are set */
+    SSD1306_COMBINE_XOR				/**< set pixels of the source are inverted */
+} ssd1306_combine_op_t;
+
+/**
+*	@brief builtin 8x5 font (see font.h for the format)
+*/
+extern const uint8_t font_8x5[];
+
+/*
+ * fixed geometry: define SSD1306_FIXED_WIDTH and SSD1306_FIXED_HEIGHT to build
+ * the driver for displays of that size only. the buffer is then part of
+ * ssd1306_t instead of being allocated, and the accessors below return
+ * constants, so address math folds into shifts and bounds checks into
+ * compares with constants.
+ */
+#if defined(SSD1306_FIXED_WIDTH)!=defined(SSD1306_FIXED_HEIGHT)
+#error "define both SSD1306_FIXED_WIDTH and SSD1306_FIXED_HEIGHT"
+#endif
+
 /**
 *	@brief holds the configuration
 */
@@ -63,13 +125,33 @@ typedef struct {
     uint8_t width; 		/**< width of display */
     uint8_t height; 	/**< height of display */
     uint8_t pages;		/**< stores pages of display (calculated on initialization*/
-    uint8_t address; 	/**< i2c address of display*/
-    i2c_inst_t *i2c_i; 	/**< i2c connection instance */
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
+    const ssd1306_transport_t *transport;	/**< transport the display is connected through */
+    void *transport_ctx;					/**< context passed to the transport */
+#ifndef SSD1306_HOST
+    ssd1306_i2c_t i2c;	/**< i2c transport context used by ssd1306_init */
+#endif
+#ifdef SSD1306_FIXED_WIDTH
+    uint8_t framebuffer[SSD1306_FIXED_WIDTH*(SSD1306_FIXED_HEIGHT/8)] __attribute__((aligned(4)));	/**< buffer points here */
+#endif
 } ssd1306_t;
 
+#ifdef SSD1306_FIXED_WIDTH
+static inline uint32_t ssd1306_width(const ssd1306_t *p) { (void) p; return SSD1306_FIXED_WIDTH; }
+static inline uint32_t ssd1306_height(const ssd1306_t *p) { (void) p; return SSD1306_FIXED_HEIGHT; }
+static inline uint32_t ssd1306_pages(const ssd1306_t *p) { (void) p; return SSD1306_FIXED_HEIGHT/8; }
+static inline uint8_t *ssd1306_buffer(ssd1306_t *p) { return p->framebuffer; }
+#else
+static inline uint32_t ssd1306_width(const ssd1306_t *p) { return p->width; }
+static inline uint32_t ssd1306_height(const ssd1306_t *p) { return p->height; }
+static inline uint32_t ssd1306_pages(const ssd1306_t *p) { return p->pages; }
+static inline uint8_t *ssd1306_buffer(ssd1306_t *p) { return p->buffer; }
+#endif
+
+static inline size_t ssd1306_bufsize(const ssd1306_t *p) { return ssd1306_width(p)*ssd1306_pages(p); }
+
 /**
 *	@brief initialize display
 *
@@ -81,9 +163,26 @@ typedef struct {
 *	
 * 	@return bool.
 *	@retval true for Success
-*	@retval false if initialization failed
+*	@retval false if initialization failed, or the size differs from SSD1306_FIXED_WIDTH/HEIGHT
 */
+#ifndef SSD1306_HOST
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
+#endif
+
+/**
+*	@brief initialize display connected through an arbitrary transport
+*
+*	@param[in] p : pointer to instance of ssd1306_t
+*	@param[in] width : width of display
+*	@param[in] height : heigth of display
+*	@param[in] transport : transport the display is connected through
+*	@param[in] ctx : context of the transport, must outlive the display
+*	
+* 	@return bool.
+*	@retval true for Success
+*	@retval false if initialization failed, or the size differs from SSD1306_FIXED_WIDTH/HEIGHT
+*/
+bool ssd1306_init_with_transport(ssd1306_t *p, uint16_t width, uint16_t height, const ssd1306_transport_t *transport, void *ctx);
 
 /**
 *	@brief deinitialize display
@@ -135,6 +234,58 @@ void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief set the column and page window that following display data is written to
+
+	@param[in] p : instance of display
+	@param[in] col_start : first column
+	@param[in] col_end : last column
+	@param[in] page_start : first page
+	@param[in] page_end : last page
+*/
+void ssd1306_set_window_region(ssd1306_t *p, uint32_t col_start, uint32_t col_end, uint32_t page_start, uint32_t page_end);
+
+/**
+	@brief send a rectangle of the buffer to the display
+
+	the rectangle is widened to whole pages vertically
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the rectangle
+	@param[in] y : y position of the rectangle
+	@param[in] width : width of the rectangle
+	@param[in] height : height of the rectangle
+*/
+void ssd1306_show_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief start displaying the buffer without waiting for the transfer
+
+	the buffer must not be modified until ssd1306_busy returns false.
+	falls back to ssd1306_show if the transport has no asynchronous writes.
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_show_async(ssd1306_t *p);
+
+/**
+	@brief check whether a transfer started by ssd1306_show_async is still running
+
+	@param[in] p : instance of display
+
+	@return true while the transfer is running
+*/
+bool ssd1306_busy(ssd1306_t *p);
+
+/**
+	@brief wait until a transfer started by ssd1306_show_async has finished
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_wait(ssd1306_t *p);
+
 /**
 	@brief clear display buffer
 
@@ -143,6 +294,38 @@ void ssd1306_show(ssd1306_t *p);
 */
 void ssd1306_clear(ssd1306_t *p);
 
+/**
+	@brief fill display buffer with a repeating pattern, 32 bits at a time
+
+	@param[in] p : instance of display
+	@param[in] pattern : four columns, the lowest byte is the leftmost; e.g. 0xaa55aa55 is a checkerboard
+*/
+void ssd1306_fill_pattern(ssd1306_t *p, uint32_t pattern);
+
+/**
+	@brief merge a buffer of the same size into the display buffer, 32 bits at a time
+
+	@param[in] p : instance of display
+	@param[in] src : page-major buffer of ssd1306_bufsize(p) bytes, ideally 4 byte aligned
+	@param[in] op : how the buffers are merged
+*/
+void ssd1306_combine(ssd1306_t *p, const uint8_t *src, ssd1306_combine_op_t op);
+
+/**
+	@brief compare display buffer with a previous copy
+
+	compares 32 bits at a time and reports the changed columns per page,
+	in the same form the widgets and the display manager use
+
+	@param[in] p : instance of display
+	@param[in] prev : page-major buffer of ssd1306_bufsize(p) bytes
+	@param[out] span_start : first changed column per page, 0xff if the page is unchanged
+	@param[out] span_end : last changed column per page, 0 if the page is unchanged
+
+	@return number of changed pages
+*/
+uint32_t ssd1306_diff(ssd1306_t *p, const uint8_t *prev, uint8_t *span_start, uint8_t *span_end);
+
 /**
 	@brief clear pixel on buffer
 
@@ -183,6 +366,20 @@ void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t
 */
 void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
+/**
+	@brief shift the pixels of a rectangle n columns to the left
+
+	the n columns freed at the right edge are cleared, pixels outside of the rectangle are kept
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] n : number of columns to shift
+*/
+void ssd1306_scroll_region_left(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t n);
+
 /**
 	@brief draw filled square at given position with given size
 
@@ -194,6 +391,17 @@ void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width,
 */
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
+/**
+	@brief invert pixels of a rectangle
+
+	@param[in] p : instance of display
+	@param[in] x : x position of rectangle
+	@param[in] y : y position of rectangle
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+*/
+void ssd1306_invert_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
 /**
 	@brief draw empty square at given position with given size
 
@@ -225,6 +433,29 @@ void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const
 */
 void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
 
+/**
+	@brief draw native page-major image, set pixels are ORed into the buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the image
+	@param[in] y : y position of the image
+	@param[in] img : image data as generated by tools/bmp2page
+
+	@note the data is one byte per column and page (bit 0 is the top row) after a
+	      SSD1306_IMG_HEADER_SIZE byte header; with SSD1306_IMG_RLE it is run-length encoded
+*/
+void ssd1306_draw_image(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img);
+
+/**
+	@brief copy native page-major image, pixels under the image are replaced
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the image
+	@param[in] y : y position of the image
+	@param[in] img : image data as generated by tools/bmp2page
+*/
+void ssd1306_copy_image(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img);
+
 /**
 	@brief draw char with given font
 
@@ -234,6 +465,9 @@ void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
 	@param[in] scale : scale font to n times of original size (default should be 1)
 	@param[in] font : pointer to font
 	@param[in] c : character to draw
+
+	@note glyphs are written as whole page bytes; for scale>1 the expanded glyph
+	      is kept in a small cache (see SSD1306_GLYPH_CACHE_ENTRIES in ssd1306.c)
 */
 void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c);
 
@@ -248,6 +482,21 @@ void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t
 */
 void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, char c);
 
+/**
+	@brief OR page-major column data into the buffer
+
+	this is the column writer the text functions draw glyphs with
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the first column
+	@param[in] y : y position of the top row
+	@param[in] src : ncols columns of col_bytes bytes each, bit 0 of a byte is its top row
+	@param[in] ncols : number of columns
+	@param[in] col_bytes : bytes per column
+	@param[in] repeat : every column is drawn repeat times horizontally
+*/
+void ssd1306_blit_columns(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *src, uint32_t ncols, uint32_t col_bytes, uint32_t repeat);
+
 /**
 	@brief draw string with given font
 
@@ -257,6 +506,9 @@ void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, cha
 	@param[in] scale : scale font to n times of original size (default should be 1)
 	@param[in] font : pointer to font
 	@param[in] s : text to draw
+
+	@note for scale>1 the glyphs of the string are laid out once in a line
+	      buffer (see SSD1306_TEXT_LINE_SIZE in ssd1306.c) and ORed in a word at a time
 */
 void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s );
 
@@ -271,4 +523,44 @@ void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_
 */
 void ssd1306_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s);
 
+/**
+	@brief width of a string in pixels
+
+	the trailing character spacing is not included
+
+	@param[in] font : pointer to font
+	@param[in] scale : scale of font
+	@param[in] s : text to measure
+
+	@return width in pixels
+*/
+uint32_t ssd1306_text_width(const uint8_t *font, uint32_t scale, const char *s);
+
+/**
+	@brief height of a line of text in pixels
+
+	@param[in] font : pointer to font
+	@param[in] scale : scale of font
+
+	@return height in pixels
+*/
+uint32_t ssd1306_text_height(const uint8_t *font, uint32_t scale);
+
+/**
+	@brief draw string aligned inside a box of given width
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the box
+	@param[in] y : y starting position of text
+	@param[in] width : width of the box
+	@param[in] scale : scale font to n times of original size (default should be 1)
+	@param[in] font : pointer to font
+	@param[in] s : text to draw
+	@param[in] align : alignment inside the box
+	@param[in] flags : combination of ssd1306_text_flags_t
+
+	@return width of the drawn text in pixels
+*/
+uint32_t ssd1306_draw_string_aligned(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t scale, const uint8_t *font, const char *s, ssd1306_align_t align, uint32_t flags);
+
 #endif
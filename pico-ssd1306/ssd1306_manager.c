@@ -0,0 +1,214 @@
+/**
+* @file ssd1306_manager.c
+*
+* schedules display updates of several ssd1306 displays
+*/
+
+#include <pico/stdlib.h>
+#include <string.h>
+
+#include "ssd1306_manager.h"
+
+static ssd1306_manager_entry_t *ssd1306_manager_find(ssd1306_manager_t *m, ssd1306_t *p) {
+    for(uint8_t i=0; i<m->count; ++i) {
+        if(m->entries[i].display==p)
+            return &m->entries[i];
+    }
+    return NULL;
+}
+
+static inline bool ssd1306_manager_in_run(const ssd1306_manager_entry_t *e) {
+    return e->page<=e->run_end;
+}
+
+static bool ssd1306_manager_bus_busy(const ssd1306_manager_t *m, const void *bus) {
+    for(uint8_t i=0; i<m->count; ++i) {
+        if(m->entries[i].bus==bus && m->entries[i].active)
+            return true;
+    }
+    return false;
+}
+
+void ssd1306_manager_init(ssd1306_manager_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->stats_since=time_us_64();
+}
+
+bool ssd1306_manager_add(ssd1306_manager_t *m, ssd1306_t *p, const void *bus) {
+    if(m->count==SSD1306_MANAGER_MAX_DISPLAYS)
+        return false;
+
+    ssd1306_manager_entry_t *e=&m->entries[m->count++];
+    memset(e, 0, sizeof(*e));
+    e->display=p;
+    e->bus=bus;
+    e->page=1;	// no run
+    memset(e->span_start, 0xff, sizeof(e->span_start));
+    return true;
+}
+
+void ssd1306_manager_flush_region(ssd1306_manager_t *m, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    ssd1306_manager_entry_t *e=ssd1306_manager_find(m, p);
+    if(e==NULL) return;
+
+    const uint32_t disp_width=ssd1306_width(p), disp_height=ssd1306_height(p);
+    if(x>=disp_width || y>=disp_height || !width || !height) return;
+    if(width>disp_width-x) width=disp_width-x;
+    if(height>disp_height-y) height=disp_height-y;
+
+    const uint32_t x_end=x+width-1, page_end=(y+height-1)>>3;
+    for(uint32_t pg=y>>3; pg<=page_end && pg<SSD1306_MANAGER_MAX_PAGES; ++pg) {
+        if(x<e->span_start[pg]) e->span_start[pg]=x;
+        if(x_end>e->span_end[pg]) e->span_end[pg]=x_end;
+    }
+
+    if(!e->queued) {
+        e->queued=true;
+        e->queued_at=time_us_64();
+    }
+}
+
+inline void ssd1306_manager_flush(ssd1306_manager_t *m, ssd1306_t *p) {
+    ssd1306_manager_flush_region(m, p, 0, 0, ssd1306_width(p), ssd1306_height(p));
+}
+
+void ssd1306_manager_flush_cb(void *ctx, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    ssd1306_manager_flush_region(ctx, p, x, y, width, height);
+}
+
+// takes the next run of pages with the same queued columns and sets the window for it
+static bool ssd1306_manager_next_run(ssd1306_manager_entry_t *e) {
+    const uint32_t disp_pages=ssd1306_pages(e->display);
+    const uint32_t pages=disp_pages<SSD1306_MANAGER_MAX_PAGES?disp_pages:SSD1306_MANAGER_MAX_PAGES;
+
+    uint32_t pg=0;
+    while(pg<pages && e->span_start[pg]>e->span_end[pg])
+        ++pg;
+    if(pg==pages)
+        return false;
+
+    uint32_t last=pg;
+    while(last+1<pages && e->span_start[last+1]==e->span_start[pg] && e->span_end[last+1]==e->span_end[pg])
+        ++last;
+
+    e->col_start=e->span_start[pg];
+    e->col_end=e->span_end[pg];
+    e->page=pg;
+    e->run_end=last;
+    for(uint32_t i=pg; i<=last; ++i) {
+        e->span_start[i]=0xff;
+        e->span_end[i]=0;
+    }
+
+    ssd1306_set_window_region(e->display, e->col_start, e->col_end, pg, last);
+    return true;
+}
+
+static void ssd1306_manager_complete(ssd1306_manager_entry_t *e, uint64_t now) {
+    const uint32_t latency=(uint32_t) (now-e->queued_at);
+
+    e->queued=false;
+    ++e->stats.flushes;
+    e->stats.last_latency_us=latency;
+    if(latency>e->stats.max_latency_us)
+        e->stats.max_latency_us=latency;
+}
+
+// called once a page row has been sent
+static void ssd1306_manager_advance(ssd1306_manager_entry_t *e, uint64_t now) {
+    ++e->page;
+    if(!ssd1306_manager_in_run(e) && !ssd1306_manager_next_run(e))
+        ssd1306_manager_complete(e, now);
+}
+
+// sends the next page row of a display, asynchronously if the transport can
+static void ssd1306_manager_start(ssd1306_manager_entry_t *e, uint64_t now) {
+    ssd1306_t *p=e->display;
+
+    if(!ssd1306_manager_in_run(e) && !ssd1306_manager_next_run(e)) {
+        ssd1306_manager_complete(e, now);
+        return;
+    }
+
+    const uint8_t *src=ssd1306_buffer(p)+e->page*ssd1306_width(p)+e->col_start;
+    const size_t len=e->col_end-e->col_start+1;
+
+    ++e->stats.transfers;
+    e->stats.bytes+=len;
+    e->started_at=now;
+
+    if(p->transport->write_data_async && p->transport->write_data_async(p->transport_ctx, src, len)) {
+        e->active=true;
+        return;
+    }
+
+    p->transport->write_data(p->transport_ctx, src, len);
+    now=time_us_64();
+    e->stats.busy_us+=now-e->started_at;
+    ssd1306_manager_advance(e, now);
+}
+
+bool ssd1306_manager_poll(ssd1306_manager_t *m) {
+    uint64_t now=time_us_64();
+    bool pending=false;
+
+    for(uint8_t i=0; i<m->count; ++i) {
+        ssd1306_manager_entry_t *e=&m->entries[i];
+        if(!e->active || ssd1306_busy(e->display))
+            continue;
+
+        e->active=false;
+        e->stats.busy_us+=now-e->started_at;
+        ssd1306_manager_advance(e, now);
+    }
+
+    // round robin, the display served first moves on every time one is served
+    for(uint8_t k=0; k<m->count; ++k) {
+        const uint8_t i=(m->next+k)%m->count;
+        ssd1306_manager_entry_t *e=&m->entries[i];
+        if(!e->queued || e->active || ssd1306_manager_bus_busy(m, e->bus))
+            continue;
+
+        ssd1306_manager_start(e, now);
+        m->next=(i+1)%m->count;
+        now=time_us_64();
+    }
+
+    for(uint8_t i=0; i<m->count; ++i)
+        pending|=m->entries[i].queued;
+
+    return pending;
+}
+
+void ssd1306_manager_run(ssd1306_manager_t *m) {
+    while(ssd1306_manager_poll(m))
+        tight_loop_contents();
+}
+
+bool ssd1306_manager_pending(ssd1306_manager_t *m, ssd1306_t *p) {
+    ssd1306_manager_entry_t *e=ssd1306_manager_find(m, p);
+    return e && e->queued;
+}
+
+const ssd1306_manager_stats_t *ssd1306_manager_stats(ssd1306_manager_t *m, ssd1306_t *p) {
+    ssd1306_manager_entry_t *e=ssd1306_manager_find(m, p);
+    return e?&e->stats:NULL;
+}
+
+uint32_t ssd1306_manager_bus_load(ssd1306_manager_t *m, const void *bus) {
+    const uint64_t elapsed=time_us_64()-m->stats_since;
+    uint64_t busy=0;
+
+    for(uint8_t i=0; i<m->count; ++i) {
+        if(m->entries[i].bus==bus)
+            busy+=m->entries[i].stats.busy_us;
+    }
+
+    return elapsed?(uint32_t) (busy*1000/elapsed):0;
+}
+
+void ssd1306_manager_reset_stats(ssd1306_manager_t *m) {
+    for(uint8_t i=0; i<m->count; ++i)
+        memset(&m->entries[i].stats, 0, sizeof(m->entries[i].stats));
+    m->stats_since=time_us_64();
+}
@@ -0,0 +1,163 @@
+/**
+* @file ssd1306_manager.h
+*
+* schedules display updates of several ssd1306 displays
+*
+* flushes are queued per display as dirty column spans per page. the manager
+* sends them one page row at a time with asynchronous transfers, taking turns
+* between the displays of a bus, so one display never waits for more than one
+* page row of every other display on its bus. displays on different buses
+* transfer at the same time.
+*/
+
+#ifndef _inc_ssd1306_manager
+#define _inc_ssd1306_manager
+#include "ssd1306.h"
+
+#ifndef SSD1306_MANAGER_MAX_DISPLAYS
+#define SSD1306_MANAGER_MAX_DISPLAYS 4
+#endif
+
+// the controller has at most 8 pages
+#define SSD1306_MANAGER_MAX_PAGES 8
+
+/**
+*	@brief transfer statistics of a display
+*/
+typedef struct {
+    uint32_t flushes;			/**< completed flushes */
+    uint32_t transfers;			/**< page rows sent */
+    uint64_t bytes;				/**< display data bytes sent */
+    uint64_t busy_us;			/**< time the bus was busy with transfers of this display */
+    uint32_t last_latency_us;	/**< time from queueing to completion of the last flush */
+    uint32_t max_latency_us;	/**< worst latency since the statistics were reset */
+} ssd1306_manager_stats_t;
+
+/**
+*	@brief a display registered with the manager
+*/
+typedef struct {
+    ssd1306_t *display;
+    const void *bus;			/**< displays with the same bus never transfer at the same time */
+    uint8_t span_start[SSD1306_MANAGER_MAX_PAGES];	/**< queued columns per page, start>end if clean */
+    uint8_t span_end[SSD1306_MANAGER_MAX_PAGES];
+    bool queued;				/**< whether a flush is queued or being sent */
+    bool active;				/**< whether a transfer is running */
+    uint8_t page;				/**< page of the running run */
+    uint8_t run_end;			/**< last page of the running run */
+    uint8_t col_start;			/**< columns of the running run */
+    uint8_t col_end;
+    uint64_t queued_at;			/**< time the pending flush was queued */
+    uint64_t started_at;		/**< time the running transfer was started */
+    ssd1306_manager_stats_t stats;
+} ssd1306_manager_entry_t;
+
+/**
+*	@brief the manager
+*/
+typedef struct {
+    ssd1306_manager_entry_t entries[SSD1306_MANAGER_MAX_DISPLAYS];
+    uint8_t count;
+    uint8_t next;				/**< entry served first on the next poll */
+    uint64_t stats_since;		/**< time the statistics were reset */
+} ssd1306_manager_t;
+
+/**
+	@brief initialize manager
+
+	@param[out] m : manager
+*/
+void ssd1306_manager_init(ssd1306_manager_t *m);
+
+/**
+	@brief register display
+
+	@param[in] m : manager
+	@param[in] p : initialized display
+	@param[in] bus : key of the bus the display is connected to, e.g. its i2c_inst_t
+
+	@return true if the display was added, false if SSD1306_MANAGER_MAX_DISPLAYS is reached
+*/
+bool ssd1306_manager_add(ssd1306_manager_t *m, ssd1306_t *p, const void *bus);
+
+/**
+	@brief queue sending a rectangle of the buffer of a display
+
+	the buffer is read when the page rows are sent, not when they are queued
+
+	@param[in] m : manager
+	@param[in] p : registered display
+	@param[in] x : x position of the rectangle
+	@param[in] y : y position of the rectangle
+	@param[in] width : width of the rectangle
+	@param[in] height : height of the rectangle
+*/
+void ssd1306_manager_flush_region(ssd1306_manager_t *m, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief queue sending the whole buffer of a display
+
+	@param[in] m : manager
+	@param[in] p : registered display
+*/
+void ssd1306_manager_flush(ssd1306_manager_t *m, ssd1306_t *p);
+
+/**
+	@brief flush callback for ssd1306_screen_render_with, ctx is the manager
+*/
+void ssd1306_manager_flush_cb(void *ctx, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief finish completed transfers and start the next ones, never blocks on a transfer
+
+	@param[in] m : manager
+
+	@return true while flushes are queued or being sent
+*/
+bool ssd1306_manager_poll(ssd1306_manager_t *m);
+
+/**
+	@brief poll until all queued flushes are sent
+
+	@param[in] m : manager
+*/
+void ssd1306_manager_run(ssd1306_manager_t *m);
+
+/**
+	@brief whether a flush of a display is queued or being sent
+
+	the buffer should not be drawn to while this is true
+
+	@param[in] m : manager
+	@param[in] p : registered display
+*/
+bool ssd1306_manager_pending(ssd1306_manager_t *m, ssd1306_t *p);
+
+/**
+	@brief statistics of a display
+
+	@param[in] m : manager
+	@param[in] p : registered display
+
+	@return statistics or NULL if the display is not registered
+*/
+const ssd1306_manager_stats_t *ssd1306_manager_stats(ssd1306_manager_t *m, ssd1306_t *p);
+
+/**
+	@brief share of the time a bus was busy since the statistics were reset
+
+	@param[in] m : manager
+	@param[in] bus : key of the bus
+
+	@return busy time in per mille
+*/
+uint32_t ssd1306_manager_bus_load(ssd1306_manager_t *m, const void *bus);
+
+/**
+	@brief reset statistics of all displays
+
+	@param[in] m : manager
+*/
+void ssd1306_manager_reset_stats(ssd1306_manager_t *m);
+
+#endif
@@ -0,0 +1,103 @@
+/**
+* @file ssd1306_power.c
+*
+* idle power policy of a ssd1306 display
+*/
+
+#include <pico/stdlib.h>
+#include <string.h>
+
+#include "ssd1306_power.h"
+
+// adds the time since the state was entered to its counter
+static void ssd1306_power_account(ssd1306_power_t *pw, uint64_t now) {
+    const uint64_t elapsed=now-pw->state_since;
+
+    switch(pw->state) {
+    case SSD1306_POWER_ON:
+        pw->stats.on_us+=elapsed;
+        break;
+    case SSD1306_POWER_DIM:
+        pw->stats.dim_us+=elapsed;
+        break;
+    case SSD1306_POWER_OFF:
+        pw->stats.off_us+=elapsed;
+        break;
+    }
+    pw->state_since=now;
+}
+
+static void ssd1306_power_enter(ssd1306_power_t *pw, ssd1306_power_state_t state, uint64_t now) {
+    ssd1306_power_account(pw, now);
+
+    if(pw->state==SSD1306_POWER_OFF)
+        ssd1306_poweron(pw->display);
+
+    switch(state) {
+    case SSD1306_POWER_ON:
+        ssd1306_contrast(pw->display, pw->contrast);
+        break;
+    case SSD1306_POWER_DIM:
+        ssd1306_contrast(pw->display, pw->dim_contrast);
+        break;
+    case SSD1306_POWER_OFF:
+        ssd1306_poweroff(pw->display);
+        break;
+    }
+    pw->state=state;
+}
+
+void ssd1306_power_init(ssd1306_power_t *pw, ssd1306_t *p, uint8_t contrast, uint8_t dim_contrast, uint32_t dim_after_ms, uint32_t off_after_ms) {
+    memset(pw, 0, sizeof(*pw));
+    pw->display=p;
+    pw->contrast=contrast;
+    pw->dim_contrast=dim_contrast;
+    pw->dim_after_ms=dim_after_ms;
+    pw->off_after_ms=off_after_ms;
+    pw->last_activity=pw->state_since=time_us_64();
+
+    ssd1306_poweron(p);
+    ssd1306_contrast(p, contrast);
+}
+
+inline void ssd1306_power_activity(ssd1306_power_t *pw) {
+    pw->last_activity=time_us_64();
+}
+
+void ssd1306_power_set_contrast(ssd1306_power_t *pw, uint8_t contrast, uint8_t dim_contrast) {
+    pw->contrast=contrast;
+    pw->dim_contrast=dim_contrast;
+
+    if(pw->state==SSD1306_POWER_ON)
+        ssd1306_contrast(pw->display, contrast);
+    else if(pw->state==SSD1306_POWER_DIM)
+        ssd1306_contrast(pw->display, dim_contrast);
+}
+
+bool ssd1306_power_update(ssd1306_power_t *pw) {
+    const uint64_t now=time_us_64();
+    const uint64_t idle_ms=(now-pw->last_activity)/1000;
+
+    ssd1306_power_state_t state=SSD1306_POWER_ON;
+    if(pw->off_after_ms && idle_ms>=pw->off_after_ms)
+        state=SSD1306_POWER_OFF;
+    else if(pw->dim_after_ms && idle_ms>=pw->dim_after_ms)
+        state=SSD1306_POWER_DIM;
+
+    if(state!=pw->state) {
+        if(pw->state==SSD1306_POWER_OFF)
+            ++pw->stats.wakes;
+        ssd1306_power_enter(pw, state, now);
+    }
+
+    if(state==SSD1306_POWER_OFF) {
+        ++pw->stats.skipped;
+        return false;
+    }
+    return true;
+}
+
+const ssd1306_power_stats_t *ssd1306_power_stats(ssd1306_power_t *pw) {
+    ssd1306_power_account(pw, time_us_64());
+    return &pw->stats;
+}
@@ -0,0 +1,99 @@
+/**
+* @file ssd1306_power.h
+*
+* idle power policy of a ssd1306 display
+*
+* without input the display is dimmed after a while and then switched off.
+* the controller keeps its display RAM while off and the buffer stays in RAM,
+* so waking up is just the two commands to switch it on and restore the
+* contrast, nothing is redrawn.
+*/
+
+#ifndef _inc_ssd1306_power
+#define _inc_ssd1306_power
+#include "ssd1306.h"
+
+/**
+*	@brief states of the power policy
+*/
+typedef enum {
+    SSD1306_POWER_ON,			/**< full contrast */
+    SSD1306_POWER_DIM,			/**< dimmed contrast */
+    SSD1306_POWER_OFF			/**< display switched off */
+} ssd1306_power_state_t;
+
+/**
+*	@brief time spent in each state and work saved while off
+*/
+typedef struct {
+    uint64_t on_us;
+    uint64_t dim_us;
+    uint64_t off_us;
+    uint32_t wakes;				/**< times the display was switched on again by input */
+    uint32_t skipped;			/**< updates skipped while off */
+} ssd1306_power_stats_t;
+
+/**
+*	@brief power policy of a display
+*/
+typedef struct {
+    ssd1306_t *display;
+    uint8_t contrast;			/**< contrast while on */
+    uint8_t dim_contrast;		/**< contrast while dimmed */
+    uint32_t dim_after_ms;		/**< time without input until dimming, 0 never dims */
+    uint32_t off_after_ms;		/**< time without input until switching off, 0 never switches off */
+    ssd1306_power_state_t state;
+    uint64_t last_activity;		/**< time of the last input */
+    uint64_t state_since;		/**< time the current state was entered */
+    ssd1306_power_stats_t stats;
+} ssd1306_power_t;
+
+/**
+	@brief initialize power policy, switches the display on with full contrast
+
+	@param[out] pw : power policy
+	@param[in] p : initialized display
+	@param[in] contrast : contrast while on
+	@param[in] dim_contrast : contrast while dimmed
+	@param[in] dim_after_ms : time without input until dimming, 0 never dims
+	@param[in] off_after_ms : time without input until switching off, 0 never switches off
+*/
+void ssd1306_power_init(ssd1306_power_t *pw, ssd1306_t *p, uint8_t contrast, uint8_t dim_contrast, uint32_t dim_after_ms, uint32_t off_after_ms);
+
+/**
+	@brief report input, the next ssd1306_power_update wakes the display
+
+	only stores the time, it is cheap enough to call on every input event
+
+	@param[in] pw : power policy
+*/
+void ssd1306_power_activity(ssd1306_power_t *pw);
+
+/**
+	@brief change the contrast levels, e.g. for a night mode
+
+	@param[in] pw : power policy
+	@param[in] contrast : contrast while on
+	@param[in] dim_contrast : contrast while dimmed
+*/
+void ssd1306_power_set_contrast(ssd1306_power_t *pw, uint8_t contrast, uint8_t dim_contrast);
+
+/**
+	@brief dim, switch off or wake the display as due, call once per frame
+
+	sends commands to the display, so no transfer to it may be running
+
+	@param[in] pw : power policy
+
+	@return false while the display is off, the frame should then not be drawn or sent
+*/
+bool ssd1306_power_update(ssd1306_power_t *pw);
+
+/**
+	@brief statistics including the time spent in the current state so far
+
+	@param[in] pw : power policy
+*/
+const ssd1306_power_stats_t *ssd1306_power_stats(ssd1306_power_t *pw);
+
+#endif
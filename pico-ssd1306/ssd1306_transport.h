@@ -0,0 +1,158 @@
+/**
+* @file ssd1306_transport.h
+*
+* transports used by the ssd1306 driver to talk to the display
+*
+* a transport is a table of functions plus a context pointer. the driver only
+* ever sends command bytes (D/C low) and display data bytes (D/C high), so every
+* bus the controller supports fits the same interface.
+*
+* with SSD1306_HOST defined only the mock transport is available, so the driver
+* can be built and run on a pc without the pico sdk.
+*/
+
+#ifndef _inc_ssd1306_transport
+#define _inc_ssd1306_transport
+#ifdef SSD1306_HOST
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#else
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+#include <hardware/spi.h>
+#endif
+
+/**
+*	@brief function table of a transport
+*
+*	write_data_async, busy, wait and deinit are optional and may be NULL.
+*	a transport without write_data_async is driven synchronously.
+*/
+typedef struct {
+    void (*write_cmds)(void *ctx, const uint8_t *cmds, size_t len);				/**< send command bytes, blocking */
+    void (*write_data)(void *ctx, const uint8_t *data, size_t len);				/**< send display data, blocking */
+    bool (*write_data_async)(void *ctx, const uint8_t *data, size_t len);		/**< start sending display data, false if it could not be started */
+    bool (*busy)(void *ctx);													/**< whether an asynchronous transfer is still running */
+    void (*wait)(void *ctx);													/**< block until an asynchronous transfer has finished */
+    void (*deinit)(void *ctx);													/**< release resources held by the transport */
+} ssd1306_transport_t;
+
+#ifndef SSD1306_HOST
+/**
+*	@brief context of the i2c transport
+*/
+typedef struct {
+    i2c_inst_t *i2c_i;	/**< i2c connection instance */
+    uint8_t address;	/**< i2c address of display */
+    int dma_chan;		/**< dma channel for asynchronous writes, -1 if not claimed yet */
+    uint16_t *dma_buf;	/**< IC_DATA_CMD words of the running asynchronous write */
+    size_t dma_buf_len;	/**< capacity of dma_buf in words */
+} ssd1306_i2c_t;
+
+/**
+*	@brief context of the 4-wire spi transport
+*/
+typedef struct {
+    spi_inst_t *spi;	/**< spi instance, initialized by the caller (8-10 MHz) */
+    uint8_t cs;			/**< chip select pin */
+    uint8_t dc;			/**< data/command pin */
+    uint8_t rst;		/**< reset pin, SSD1306_SPI_NO_RST if not connected */
+    int dma_chan;		/**< dma channel for asynchronous writes, -1 if not claimed yet */
+    bool selected;		/**< whether cs is asserted by a running transfer */
+} ssd1306_spi_t;
+
+/**
+*	@brief value for ssd1306_spi_t::rst when the reset pin is not connected
+*/
+#define SSD1306_SPI_NO_RST 0xff
+#endif
+
+/**
+*	@brief context of the in-memory mock transport
+*
+*	emulates the GDDRAM of a 128x64 controller in horizontal addressing mode,
+*	the command parser understands the commands issued by this driver
+*/
+typedef struct {
+    uint8_t ram[8*128];			/**< emulated GDDRAM, page-major like ssd1306_t::buffer */
+    uint8_t col_start;			/**< column window set by SET_COL_ADDR */
+    uint8_t col_end;
+    uint8_t page_start;			/**< page window set by SET_PAGE_ADDR */
+    uint8_t page_end;
+    uint8_t col;				/**< current write position */
+    uint8_t page;
+    uint8_t cmd[7];				/**< command being assembled */
+    uint8_t cmd_len;
+    uint8_t cmd_need;
+    bool display_on;			/**< state set by SET_DISP */
+    bool inverted;				/**< state set by SET_NORM_INV */
+    uint8_t contrast;			/**< state set by SET_CONTRAST */
+    uint32_t cmd_bytes;			/**< number of command bytes received */
+    uint32_t data_bytes;		/**< number of data bytes received */
+    uint32_t transfers;			/**< number of write_cmds/write_data calls */
+} ssd1306_mock_t;
+
+#ifndef SSD1306_HOST
+/**
+*	@brief i2c transport, context is a ssd1306_i2c_t
+*/
+extern const ssd1306_transport_t ssd1306_transport_i2c;
+
+/**
+*	@brief 4-wire spi transport, context is a ssd1306_spi_t
+*/
+extern const ssd1306_transport_t ssd1306_transport_spi;
+#endif
+
+/**
+*	@brief in-memory mock transport, context is a ssd1306_mock_t
+*/
+extern const ssd1306_transport_t ssd1306_transport_mock;
+
+#ifndef SSD1306_HOST
+/**
+	@brief set up i2c transport context
+
+	@param[out] t : context to set up
+	@param[in] i2c_instance : instance of i2c connection, initialized by the caller
+	@param[in] address : i2c address of display
+*/
+void ssd1306_i2c_setup(ssd1306_i2c_t *t, i2c_inst_t *i2c_instance, uint8_t address);
+
+/**
+	@brief set up spi transport context, configure cs/dc/rst pins and reset the display
+
+	@param[out] t : context to set up
+	@param[in] spi : spi instance, initialized by the caller
+	@param[in] cs : chip select pin
+	@param[in] dc : data/command pin
+	@param[in] rst : reset pin or SSD1306_SPI_NO_RST
+*/
+void ssd1306_spi_setup(ssd1306_spi_t *t, spi_inst_t *spi, uint8_t cs, uint8_t dc, uint8_t rst);
+#endif
+
+/**
+	@brief reset mock transport context to a powered up, blank controller
+
+	@param[out] t : context to reset
+*/
+void ssd1306_mock_setup(ssd1306_mock_t *t);
+
+#ifdef SSD1306_HOST
+/**
+	@brief write what the panel of a mock shows as binary pbm image
+
+	lit pixels are white, a powered off panel is all black and an inverted one is inverted
+
+	@param[in] t : mock context
+	@param[in] width : width of display, 64 wide displays use columns 32 to 95 of the GDDRAM
+	@param[in] height : height of display
+	@param[in] path : file to write
+
+	@return true if the file was written
+*/
+bool ssd1306_mock_write_pbm(const ssd1306_mock_t *t, uint8_t width, uint8_t height, const char *path);
+#endif
+
+#endif
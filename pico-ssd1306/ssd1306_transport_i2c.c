@@ -0,0 +1,162 @@
+/**
+* @file ssd1306_transport_i2c.c
+*
+* i2c transport for ssd1306 displays
+*
+* every transaction starts with a control byte: 0x00 for commands, 0x40 for
+* display data. blocking writes go through i2c_write_blocking, asynchronous
+* writes are fed to IC_DATA_CMD by dma.
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+#include <hardware/dma.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ssd1306_transport.h"
+
+// largest payload of one blocking data transaction, one page of a 128 wide display
+#ifndef SSD1306_I2C_CHUNK
+#define SSD1306_I2C_CHUNK 128
+#endif
+
+#define SSD1306_I2C_CTRL_CMD 0x00
+#define SSD1306_I2C_CTRL_DATA 0x40
+
+inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
+    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+    case PICO_ERROR_GENERIC:
+        printf("[%s] addr not acknowledged!\n", name);
+        break;
+    case PICO_ERROR_TIMEOUT:
+        printf("[%s] timeout!\n", name);
+        break;
+    default:
+        //printf("[%s] wrote successfully %lu bytes!\n", name, len);
+        break;
+    }
+}
+
+static bool i2c_busy(void *ctx) {
+    ssd1306_i2c_t *t=ctx;
+    if(t->dma_chan<0)
+        return false;
+
+    i2c_hw_t *hw=i2c_get_hw(t->i2c_i);
+    if(dma_channel_is_busy(t->dma_chan) || hw->txflr || (hw->status&I2C_IC_STATUS_ACTIVITY_BITS))
+        return true;
+
+    if(hw->raw_intr_stat&I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        (void) hw->clr_tx_abrt;
+        printf("[ssd1306_i2c] async write aborted!\n");
+    }
+
+    return false;
+}
+
+static void i2c_wait(void *ctx) {
+    while(i2c_busy(ctx))
+        tight_loop_contents();
+}
+
+static void i2c_write_cmds(void *ctx, const uint8_t *cmds, size_t len) {
+    ssd1306_i2c_t *t=ctx;
+    uint8_t buf[SSD1306_I2C_CHUNK+1];
+
+    i2c_wait(ctx);
+
+    buf[0]=SSD1306_I2C_CTRL_CMD;
+    while(len) {
+        size_t n=len<SSD1306_I2C_CHUNK?len:SSD1306_I2C_CHUNK;
+        memcpy(buf+1, cmds, n);
+        fancy_write(t->i2c_i, t->address, buf, n+1, "ssd1306_write");
+        cmds+=n;
+        len-=n;
+    }
+}
+
+static void i2c_write_data(void *ctx, const uint8_t *data, size_t len) {
+    ssd1306_i2c_t *t=ctx;
+    uint8_t buf[SSD1306_I2C_CHUNK+1];
+
+    i2c_wait(ctx);
+
+    buf[0]=SSD1306_I2C_CTRL_DATA;
+    while(len) {
+        size_t n=len<SSD1306_I2C_CHUNK?len:SSD1306_I2C_CHUNK;
+        memcpy(buf+1, data, n);
+        fancy_write(t->i2c_i, t->address, buf, n+1, "ssd1306_show");
+        data+=n;
+        len-=n;
+    }
+}
+
+static bool i2c_write_data_async(void *ctx, const uint8_t *data, size_t len) {
+    ssd1306_i2c_t *t=ctx;
+
+    i2c_wait(ctx);
+
+    if(t->dma_chan<0 && (t->dma_chan=dma_claim_unused_channel(false))<0)
+        return false;
+
+    if(t->dma_buf_len<len+1) {
+        uint16_t *buf=realloc(t->dma_buf, (len+1)*sizeof(uint16_t));
+        if(buf==NULL)
+            return false;
+        t->dma_buf=buf;
+        t->dma_buf_len=len+1;
+    }
+
+    // the controller holds the bus when its fifo runs empty, so the last word carries the stop
+    t->dma_buf[0]=SSD1306_I2C_CTRL_DATA;
+    for(size_t i=0; i<len; ++i)
+        t->dma_buf[i+1]=data[i];
+    t->dma_buf[len]|=I2C_IC_DATA_CMD_STOP_BITS;
+
+    i2c_hw_t *hw=i2c_get_hw(t->i2c_i);
+    hw->enable=0;
+    hw->tar=t->address;
+    hw->enable=1;
+
+    dma_channel_config c=dma_channel_get_default_config(t->dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(t->i2c_i, true));
+    dma_channel_configure(t->dma_chan, &c, &hw->data_cmd, t->dma_buf, len+1, true);
+
+    return true;
+}
+
+static void i2c_deinit(void *ctx) {
+    ssd1306_i2c_t *t=ctx;
+
+    i2c_wait(ctx);
+
+    if(t->dma_chan>=0) {
+        dma_channel_unclaim(t->dma_chan);
+        t->dma_chan=-1;
+    }
+    free(t->dma_buf);
+    t->dma_buf=NULL;
+    t->dma_buf_len=0;
+}
+
+void ssd1306_i2c_setup(ssd1306_i2c_t *t, i2c_inst_t *i2c_instance, uint8_t address) {
+    t->i2c_i=i2c_instance;
+    t->address=address;
+    t->dma_chan=-1;
+    t->dma_buf=NULL;
+    t->dma_buf_len=0;
+}
+
+const ssd1306_transport_t ssd1306_transport_i2c= {
+    .write_cmds=i2c_write_cmds,
+    .write_data=i2c_write_data,
+    .write_data_async=i2c_write_data_async,
+    .busy=i2c_busy,
+    .wait=i2c_wait,
+    .deinit=i2c_deinit,
+};
@@ -0,0 +1,149 @@
+/**
+* @file ssd1306_transport_mock.c
+*
+* in-memory mock transport for ssd1306 displays
+*
+* parses the command stream like the controller does and writes display data
+* into an emulated GDDRAM, so the driver can be exercised without hardware.
+*/
+
+#include <string.h>
+#ifdef SSD1306_HOST
+#include <stdio.h>
+#endif
+
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+
+// number of argument bytes following a command byte
+static uint8_t mock_cmd_args(uint8_t cmd) {
+    switch(cmd) {
+    case SET_COL_ADDR:
+    case SET_PAGE_ADDR:
+    case 0xA3: // vertical scroll area
+        return 2;
+    case 0x26: // horizontal scroll
+    case 0x27:
+        return 6;
+    case 0x29: // vertical and horizontal scroll
+    case 0x2A:
+        return 5;
+    case SET_CONTRAST:
+    case SET_MEM_ADDR:
+    case SET_MUX_RATIO:
+    case SET_DISP_OFFSET:
+    case SET_COM_PIN_CFG:
+    case SET_DISP_CLK_DIV:
+    case SET_PRECHARGE:
+    case SET_VCOM_DESEL:
+    case SET_CHARGE_PUMP:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void mock_exec(ssd1306_mock_t *t) {
+    const uint8_t *c=t->cmd;
+
+    switch(c[0]) {
+    case SET_COL_ADDR:
+        t->col_start=t->col=c[1]&0x7f;
+        t->col_end=c[2]&0x7f;
+        break;
+    case SET_PAGE_ADDR:
+        t->page_start=t->page=c[1]&0x07;
+        t->page_end=c[2]&0x07;
+        break;
+    case SET_CONTRAST:
+        t->contrast=c[1];
+        break;
+    case SET_DISP:
+    case SET_DISP|0x01:
+        t->display_on=c[0]&1;
+        break;
+    case SET_NORM_INV:
+    case SET_NORM_INV|0x01:
+        t->inverted=c[0]&1;
+        break;
+    default:
+        break;
+    }
+}
+
+static void mock_write_cmds(void *ctx, const uint8_t *cmds, size_t len) {
+    ssd1306_mock_t *t=ctx;
+
+    ++t->transfers;
+    t->cmd_bytes+=len;
+
+    for(size_t i=0; i<len; ++i) {
+        if(t->cmd_len==0)
+            t->cmd_need=mock_cmd_args(cmds[i])+1;
+
+        t->cmd[t->cmd_len++]=cmds[i];
+
+        if(t->cmd_len==t->cmd_need) {
+            mock_exec(t);
+            t->cmd_len=0;
+        }
+    }
+}
+
+static void mock_write_data(void *ctx, const uint8_t *data, size_t len) {
+    ssd1306_mock_t *t=ctx;
+
+    ++t->transfers;
+    t->data_bytes+=len;
+
+    for(size_t i=0; i<len; ++i) {
+        t->ram[t->page*128+t->col]=data[i];
+
+        if(t->col<t->col_end) {
+            ++t->col;
+            continue;
+        }
+
+        t->col=t->col_start;
+        t->page=t->page<t->page_end?t->page+1:t->page_start;
+    }
+}
+
+void ssd1306_mock_setup(ssd1306_mock_t *t) {
+    memset(t, 0, sizeof(*t));
+    t->col_end=127;
+    t->page_end=7;
+    t->contrast=0x7f;
+}
+
+#ifdef SSD1306_HOST
+bool ssd1306_mock_write_pbm(const ssd1306_mock_t *t, uint8_t width, uint8_t height, const char *path) {
+    FILE *f=fopen(path, "wb");
+    if(f==NULL)
+        return false;
+
+    const uint32_t col_offset=width==64?32:0;
+    const uint32_t row_bytes=(width+7)/8;
+
+    fprintf(f, "P4\n%u %u\n", width, height);
+    for(uint32_t y=0; y<height; ++y) {
+        uint8_t row[16]= {0};
+        for(uint32_t x=0; x<width; ++x) {
+            bool lit=(t->ram[(y>>3)*128+col_offset+x]>>(y&7))&1;
+            if(t->inverted)
+                lit=!lit;
+            // pbm: 1 is black
+            if(!t->display_on || !lit)
+                row[x>>3]|=0x80>>(x&7);
+        }
+        fwrite(row, 1, row_bytes, f);
+    }
+
+    return fclose(f)==0;
+}
+#endif
+
+const ssd1306_transport_t ssd1306_transport_mock= {
+    .write_cmds=mock_write_cmds,
+    .write_data=mock_write_data,
+};
@@ -0,0 +1,137 @@
+/**
+* @file ssd1306_transport_spi.c
+*
+* 4-wire spi transport for ssd1306 displays
+*
+* the D/C pin selects between command and display data, there is no control
+* byte. asynchronous writes are fed to the spi tx fifo by dma, cs is released
+* once the transfer has been observed as finished.
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/spi.h>
+#include <hardware/dma.h>
+
+#include "ssd1306_transport.h"
+
+static inline void spi_select(ssd1306_spi_t *t, bool data) {
+    gpio_put(t->dc, data);
+    gpio_put(t->cs, 0);
+    t->selected=true;
+}
+
+static inline void spi_deselect(ssd1306_spi_t *t) {
+    gpio_put(t->cs, 1);
+    t->selected=false;
+}
+
+static bool spi_busy(void *ctx) {
+    ssd1306_spi_t *t=ctx;
+    if(t->dma_chan>=0 && dma_channel_is_busy(t->dma_chan))
+        return true;
+
+    if(!t->selected)
+        return false;
+
+    if(spi_is_busy(t->spi))
+        return true;
+
+    // dma only fills the tx fifo, drop what was clocked in meanwhile
+    while(spi_is_readable(t->spi))
+        (void) spi_get_hw(t->spi)->dr;
+    spi_get_hw(t->spi)->icr=SPI_SSPICR_RORIC_BITS;
+
+    spi_deselect(t);
+    return false;
+}
+
+static void spi_wait(void *ctx) {
+    while(spi_busy(ctx))
+        tight_loop_contents();
+}
+
+static void spi_write(ssd1306_spi_t *t, const uint8_t *src, size_t len, bool data) {
+    spi_wait(t);
+
+    spi_select(t, data);
+    spi_write_blocking(t->spi, src, len);
+    spi_deselect(t);
+}
+
+static void spi_write_cmds(void *ctx, const uint8_t *cmds, size_t len) {
+    spi_write(ctx, cmds, len, false);
+}
+
+static void spi_write_data(void *ctx, const uint8_t *data, size_t len) {
+    spi_write(ctx, data, len, true);
+}
+
+static bool spi_write_data_async(void *ctx, const uint8_t *data, size_t len) {
+    ssd1306_spi_t *t=ctx;
+
+    spi_wait(ctx);
+
+    if(t->dma_chan<0 && (t->dma_chan=dma_claim_unused_channel(false))<0)
+        return false;
+
+    spi_select(t, true);
+
+    dma_channel_config c=dma_channel_get_default_config(t->dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(t->spi, true));
+    dma_channel_configure(t->dma_chan, &c, &spi_get_hw(t->spi)->dr, data, len, true);
+
+    return true;
+}
+
+static void spi_deinit(void *ctx) {
+    ssd1306_spi_t *t=ctx;
+
+    spi_wait(ctx);
+
+    if(t->dma_chan>=0) {
+        dma_channel_unclaim(t->dma_chan);
+        t->dma_chan=-1;
+    }
+}
+
+void ssd1306_spi_setup(ssd1306_spi_t *t, spi_inst_t *spi, uint8_t cs, uint8_t dc, uint8_t rst) {
+    t->spi=spi;
+    t->cs=cs;
+    t->dc=dc;
+    t->rst=rst;
+    t->dma_chan=-1;
+    t->selected=false;
+
+    gpio_init(cs);
+    gpio_set_dir(cs, GPIO_OUT);
+    gpio_put(cs, 1);
+
+    gpio_init(dc);
+    gpio_set_dir(dc, GPIO_OUT);
+    gpio_put(dc, 0);
+
+    if(rst==SSD1306_SPI_NO_RST)
+        return;
+
+    // reset pulse, the controller needs at least 3us low
+    gpio_init(rst);
+    gpio_set_dir(rst, GPIO_OUT);
+    gpio_put(rst, 1);
+    sleep_ms(1);
+    gpio_put(rst, 0);
+    sleep_us(10);
+    gpio_put(rst, 1);
+    sleep_ms(1);
+}
+
+const ssd1306_transport_t ssd1306_transport_spi= {
+    .write_cmds=spi_write_cmds,
+    .write_data=spi_write_data,
+    .write_data_async=spi_write_data_async,
+    .busy=spi_busy,
+    .wait=spi_wait,
+    .deinit=spi_deinit,
+};
@@ -0,0 +1,183 @@
+/**
+* @file ssd1306_utf8.c
+*
+* utf-8 text with the CP0-EU 8x8 font of the ws2812b animation library
+*/
+
+#include <string.h>
+
+#include "ssd1306_utf8.h"
+#include "CP0_EU_8x8.h"
+#include "CP0_EU_lookup.h"
+#include "utf-8.h"
+
+#define SSD1306_UTF8_ELLIPSIS cp0_eu_glyph(0x2026)
+
+// glyphs transposed to page-major columns on first use
+static bool ready;
+static uint8_t columns[256][8];
+
+typedef struct {
+    const char *s;
+    uint8_t count;
+    uint16_t bytes;	// of text
+    uint8_t glyphs[SSD1306_UTF8_MAX_GLYPHS];
+    char text[4*SSD1306_UTF8_MAX_GLYPHS+1];	// the bytes the glyphs were decoded from
+} ssd1306_utf8_run_t;
+
+static ssd1306_utf8_run_t run_cache[SSD1306_UTF8_CACHE_ENTRIES];
+static uint32_t run_cache_next;
+
+static void ssd1306_utf8_setup(void) {
+    // rows with the leftmost column in the msb to columns with the top row in bit 0
+    for(uint32_t i=0; i<256; ++i) {
+        for(uint32_t r=0; r<8; ++r) {
+            const uint8_t row=(uint8_t) CP0_EU_8x8[i][r];
+            for(uint32_t c=0; c<8; ++c)
+                columns[i][c]|=((row>>(7-c))&1)<<r;
+        }
+    }
+
+    ready=true;
+}
+
+uint8_t ssd1306_utf8_glyph(uint32_t codepoint) {
+    return cp0_eu_glyph(codepoint);
+}
+
+// *bytes, if given, is set to the length of s the glyphs depend on
+static uint32_t ssd1306_utf8_decode(const char *s, uint8_t *glyphs, uint32_t *bytes) {
+    utf8_iter iter;
+    uint32_t n=0;
+
+    utf8_init(&iter, s);
+    while(n<SSD1306_UTF8_MAX_GLYPHS && utf8_next(&iter))
+        glyphs[n++]=ssd1306_utf8_glyph(iter.codepoint);
+
+    // decoding stops at the terminating 0 or an invalid byte, so that byte belongs to the text too
+    if(bytes)
+        *bytes=n<SSD1306_UTF8_MAX_GLYPHS?iter.next+1:iter.next;
+
+    return n;
+}
+
+/*
+ * decoded glyphs of a string flagged with SSD1306_TEXT_CONST, replaced round
+ * robin. an entry is reused only while the text at the pointer matches the
+ * bytes it was decoded from, a buffer that was written since is decoded again.
+ */
+static const ssd1306_utf8_run_t *ssd1306_utf8_cached(const char *s) {
+    ssd1306_utf8_run_t *e=NULL;
+    for(uint32_t i=0; i<SSD1306_UTF8_CACHE_ENTRIES && !e; ++i)
+        if(run_cache[i].s==s)
+            e=&run_cache[i];
+
+    if(e && !strncmp(e->text, s, e->bytes))
+        return e;
+
+    if(!e) {
+        e=&run_cache[run_cache_next];
+        run_cache_next=(run_cache_next+1)%SSD1306_UTF8_CACHE_ENTRIES;
+    }
+
+    uint32_t bytes;
+    e->count=ssd1306_utf8_decode(s, e->glyphs, &bytes);
+
+    // text that is not valid utf-8 may not fit, it is decoded every time
+    if(bytes<=sizeof(e->text)) {
+        e->s=s;
+        e->bytes=bytes;
+        memcpy(e->text, s, bytes);
+    } else {
+        e->s=NULL;
+    }
+
+    return e;
+}
+
+static inline uint32_t ssd1306_utf8_glyph_width(uint8_t g) {
+    return CP0_EU_8x8_offsets[2*g+1]-CP0_EU_8x8_offsets[2*g]+1;
+}
+
+// width including the trailing spacing
+static uint32_t ssd1306_utf8_advance(const uint8_t *glyphs, uint32_t n) {
+    uint32_t w=0;
+    for(uint32_t i=0; i<n; ++i)
+        w+=ssd1306_utf8_glyph_width(glyphs[i])+1;
+    return w;
+}
+
+static uint32_t ssd1306_utf8_blit(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *glyphs, uint32_t n) {
+    const uint32_t x_start=x;
+
+    if(!ready)
+        ssd1306_utf8_setup();
+
+    for(uint32_t i=0; i<n; ++i) {
+        const uint8_t g=glyphs[i];
+        const uint32_t w=ssd1306_utf8_glyph_width(g);
+
+        ssd1306_blit_columns(p, x, y, columns[g]+CP0_EU_8x8_offsets[2*g], w, 1, 1);
+        x+=w+1;
+    }
+
+    return x>x_start?x-x_start-1:0;
+}
+
+uint32_t ssd1306_utf8_width(const char *s) {
+    uint8_t glyphs[SSD1306_UTF8_MAX_GLYPHS];
+    const uint32_t w=ssd1306_utf8_advance(glyphs, ssd1306_utf8_decode(s, glyphs, NULL));
+    return w?w-1:0;
+}
+
+uint32_t ssd1306_draw_utf8(ssd1306_t *p, uint32_t x, uint32_t y, const char *s) {
+    uint8_t glyphs[SSD1306_UTF8_MAX_GLYPHS];
+    return ssd1306_utf8_blit(p, x, y, glyphs, ssd1306_utf8_decode(s, glyphs, NULL));
+}
+
+uint32_t ssd1306_draw_utf8_aligned(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, const char *s, ssd1306_align_t align, uint32_t flags) {
+    uint8_t decoded[SSD1306_UTF8_MAX_GLYPHS+1];
+    const uint8_t *glyphs=decoded;
+    uint32_t n;
+
+    if(flags&SSD1306_TEXT_CONST) {
+        const ssd1306_utf8_run_t *r=ssd1306_utf8_cached(s);
+        glyphs=r->glyphs;
+        n=r->count;
+    } else {
+        n=ssd1306_utf8_decode(s, decoded, NULL);
+    }
+
+    // widths below include the trailing spacing, so the box gets one extra column
+    uint32_t text_width=ssd1306_utf8_advance(glyphs, n);
+
+    if((flags&(SSD1306_TEXT_CLIP|SSD1306_TEXT_ELLIPSIS)) && text_width>width+1) {
+        const uint32_t dots=(flags&SSD1306_TEXT_ELLIPSIS)?ssd1306_utf8_glyph_width(SSD1306_UTF8_ELLIPSIS)+1:0;
+
+        while(n && text_width+(dots<=width+1?dots:0)>width+1)
+            text_width-=ssd1306_utf8_glyph_width(glyphs[--n])+1;
+
+        if(dots && text_width+dots<=width+1) {
+            if(glyphs!=decoded)
+                memcpy(decoded, glyphs, n);
+            decoded[n++]=SSD1306_UTF8_ELLIPSIS;
+            glyphs=decoded;
+            text_width+=dots;
+        }
+    }
+
+    text_width=text_width?text_width-1:0;
+
+    if(align==SSD1306_ALIGN_CENTER && text_width<width)
+        x+=(width-text_width)/2;
+    else if(align==SSD1306_ALIGN_RIGHT && text_width<width)
+        x+=width-text_width;
+
+    return ssd1306_utf8_blit(p, x, y, glyphs, n);
+}
+
+uint32_t ssd1306_utf8_text(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t scale, const uint8_t *font, const char *s, ssd1306_align_t align, uint32_t flags) {
+    (void) scale;
+    (void) font;
+    return ssd1306_draw_utf8_aligned(p, x, y, width, s, align, flags);
+}
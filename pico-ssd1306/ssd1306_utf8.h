@@ -0,0 +1,90 @@
+/**
+* @file ssd1306_utf8.h
+*
+* utf-8 text with the CP0-EU 8x8 font of the ws2812b animation library
+*
+* strings are decoded once into glyph indices, code points are looked up with
+* cp0_eu_glyph() from CP0_EU_lookup.h and the glyphs are transposed on first use
+* into the column-major layout of the display buffer, so drawing a
+* glyph is a single ssd1306_blit_columns. glyphs are drawn proportionally,
+* trimmed to the columns given by CP0_EU_8x8_offsets plus one column of
+* spacing. code points the font does not cover are drawn as a bullet.
+*
+* this file is not part of the pico-ssd1306 library, it needs the inc, CP0-EU
+* and utf8-iterator include directories of the ws2812b animation library.
+*/
+
+#ifndef _inc_ssd1306_utf8
+#define _inc_ssd1306_utf8
+#include "ssd1306.h"
+
+#define SSD1306_UTF8_HEIGHT 8
+
+#ifndef SSD1306_UTF8_MAX_GLYPHS
+#define SSD1306_UTF8_MAX_GLYPHS 32		// longer strings are cut
+#endif
+
+#ifndef SSD1306_UTF8_CACHE_ENTRIES
+#define SSD1306_UTF8_CACHE_ENTRIES 8	// decoded strings flagged with SSD1306_TEXT_CONST
+#endif
+
+/**
+	@brief glyph index of a code point
+
+	@param[in] codepoint : unicode code point
+
+	@return index into CP0_EU_8x8, CP0_EU_FALLBACK_GLYPH (a bullet) if the font lacks the code point
+*/
+uint8_t ssd1306_utf8_glyph(uint32_t codepoint);
+
+/**
+	@brief width of a utf-8 string in pixels
+
+	the trailing glyph spacing is not included
+
+	@param[in] s : text to measure
+
+	@return width in pixels
+*/
+uint32_t ssd1306_utf8_width(const char *s);
+
+/**
+	@brief draw utf-8 string
+
+	@param[in] p : instance of display
+	@param[in] x : x starting position of text
+	@param[in] y : y starting position of text
+	@param[in] s : text to draw
+
+	@return width of the drawn text in pixels
+*/
+uint32_t ssd1306_draw_utf8(ssd1306_t *p, uint32_t x, uint32_t y, const char *s);
+
+/**
+	@brief draw utf-8 string aligned inside a box of given width
+
+	with SSD1306_TEXT_CONST the decoded glyphs are kept and reused for the
+	same string pointer while the text there is unchanged. with SSD1306_TEXT_ELLIPSIS clipped text ends with "…"
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the box
+	@param[in] y : y starting position of text
+	@param[in] width : width of the box
+	@param[in] s : text to draw
+	@param[in] align : alignment inside the box
+	@param[in] flags : combination of ssd1306_text_flags_t
+
+	@return width of the drawn text in pixels
+*/
+uint32_t ssd1306_draw_utf8_aligned(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, const char *s, ssd1306_align_t align, uint32_t flags);
+
+/**
+	@brief ssd1306_draw_utf8_aligned with the signature of ssd1306_draw_string_aligned
+
+	set as draw_text of a widget to show its text with this font. scale and font are ignored
+
+	@return width of the drawn text in pixels
+*/
+uint32_t ssd1306_utf8_text(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t scale, const uint8_t *font, const char *s, ssd1306_align_t align, uint32_t flags);
+
+#endif
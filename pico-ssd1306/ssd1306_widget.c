@@ -0,0 +1,259 @@
+/**
+* @file ssd1306_widget.c
+*
+* retained-mode widgets for ssd1306 displays
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306_widget.h"
+
+// the controller has at most 8 pages
+#define SSD1306_WIDGET_MAX_PAGES 8
+
+static void ssd1306_widget_setup(ssd1306_widget_t *w, ssd1306_widget_type_t type, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    memset(w, 0, sizeof(*w));
+    w->type=type;
+    w->x=x;
+    w->y=y;
+    w->width=width;
+    w->height=height;
+    w->dirty=true;
+    w->font=font_8x5;
+    w->draw_text=ssd1306_draw_string_aligned;
+    w->align=SSD1306_ALIGN_LEFT;
+}
+
+void ssd1306_label_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, const char *text, ssd1306_align_t align) {
+    ssd1306_widget_setup(w, SSD1306_WIDGET_LABEL, x, y, width, ssd1306_text_height(font_8x5, 1));
+    w->align=align;
+    w->label.text=text;
+}
+
+void ssd1306_number_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, const char *fmt, ssd1306_align_t align) {
+    ssd1306_widget_setup(w, SSD1306_WIDGET_NUMBER, x, y, width, ssd1306_text_height(font_8x5, 1));
+    w->align=align;
+    w->number.fmt=fmt;
+}
+
+void ssd1306_bar_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, float max) {
+    ssd1306_widget_setup(w, SSD1306_WIDGET_BAR, x, y, width, height);
+    w->bar.max=max;
+}
+
+void ssd1306_chart_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, float *values, uint8_t count, float max) {
+    ssd1306_widget_setup(w, SSD1306_WIDGET_CHART, x, y, width, height);
+    w->chart.values=values;
+    w->chart.count=count;
+    w->chart.max=max;
+}
+
+void ssd1306_selector_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t row_height, const char *const *items, uint8_t count) {
+    uint8_t height=count?(count-1)*row_height+ssd1306_text_height(font_8x5, 1):0;
+    ssd1306_widget_setup(w, SSD1306_WIDGET_SELECTOR, x, y, width, height);
+    w->align=SSD1306_ALIGN_CENTER;
+    w->selector.items=items;
+    w->selector.count=count;
+    w->selector.row_height=row_height;
+}
+
+void ssd1306_label_set(ssd1306_widget_t *w, const char *text) {
+    if(w->label.text==text) return;
+
+    w->label.text=text;
+    w->dirty=true;
+}
+
+void ssd1306_number_set(ssd1306_widget_t *w, float value) {
+    char text[SSD1306_WIDGET_TEXT_LEN];
+    snprintf(text, sizeof(text), w->number.fmt, value);
+
+    if(!strcmp(text, w->number.text)) return;
+
+    memcpy(w->number.text, text, sizeof(text));
+    w->dirty=true;
+}
+
+void ssd1306_bar_set(ssd1306_widget_t *w, float value) {
+    uint8_t fill=0;
+    if(value>=w->bar.max)
+        fill=w->width;
+    else if(value>0)
+        fill=(uint8_t) (value/w->bar.max*w->width);
+
+    if(fill==w->bar.fill) return;
+
+    w->bar.fill=fill;
+    w->dirty=true;
+}
+
+void ssd1306_chart_push(ssd1306_widget_t *w, float value) {
+    w->chart.values[w->chart.head]=value;
+    if(++w->chart.head==w->chart.count)
+        w->chart.head=0;
+    if(w->chart.pushed<w->chart.count)
+        ++w->chart.pushed;
+}
+
+void ssd1306_selector_set(ssd1306_widget_t *w, uint8_t selected) {
+    if(selected==w->selector.selected) return;
+
+    w->selector.selected=selected;
+    w->dirty=true;
+}
+
+inline void ssd1306_widget_invalidate(ssd1306_widget_t *w) {
+    w->dirty=true;
+}
+
+// y of the i-th oldest value
+static int32_t ssd1306_chart_y(const ssd1306_widget_t *w, uint32_t i) {
+    const int32_t range=w->height-1;
+    uint32_t k=w->chart.head+i;
+    if(k>=w->chart.count)
+        k-=w->chart.count;
+
+    float v=w->chart.values[k];
+    if(v<0) v=0;
+    if(v>w->chart.max) v=w->chart.max;
+
+    return w->y+range-(int32_t) (v/w->chart.max*range);
+}
+
+// line from the (i-1)-th to the i-th oldest value
+static void ssd1306_chart_segment(ssd1306_t *p, const ssd1306_widget_t *w, uint32_t i) {
+    const int32_t step=(w->width-1)/(w->chart.count-1);
+    ssd1306_draw_line(p, w->x+(i-1)*step, ssd1306_chart_y(w, i-1), w->x+i*step, ssd1306_chart_y(w, i));
+}
+
+/*
+ * shifts the drawn chart left by one step per pushed value and draws only the
+ * new segments. the leftmost column still holds the end of the dropped segment,
+ * so it is cleared and the first segment (whose pixels are already there) is
+ * drawn again. returns false if most of the chart changed anyway.
+ */
+static bool ssd1306_chart_scroll(ssd1306_t *p, ssd1306_widget_t *w) {
+    const uint32_t count=w->chart.count, pushed=w->chart.pushed;
+    if(count<2 || pushed>=count-1) return false;
+
+    const uint32_t step=(w->width-1)/(count-1);
+    ssd1306_scroll_region_left(p, w->x, w->y, w->width, w->height, step*pushed);
+    ssd1306_clear_square(p, w->x, w->y, 1, w->height);
+    ssd1306_chart_segment(p, w, 1);
+
+    for(uint32_t i=count-pushed; i<count; ++i)
+        ssd1306_chart_segment(p, w, i);
+
+    w->chart.pushed=0;
+    return true;
+}
+
+static void ssd1306_widget_draw(ssd1306_t *p, ssd1306_widget_t *w) {
+    switch(w->type) {
+    case SSD1306_WIDGET_LABEL:
+        w->draw_text(p, w->x, w->y, w->width, 1, w->font, w->label.text, w->align, SSD1306_TEXT_ELLIPSIS|SSD1306_TEXT_CONST);
+        break;
+    case SSD1306_WIDGET_NUMBER:
+        w->draw_text(p, w->x, w->y, w->width, 1, w->font, w->number.text, w->align, SSD1306_TEXT_ELLIPSIS);
+        break;
+    case SSD1306_WIDGET_BAR:
+        ssd1306_draw_square(p, w->x, w->y, w->bar.fill, w->height);
+        break;
+    case SSD1306_WIDGET_CHART:
+        for(uint32_t i=1; i<w->chart.count; ++i)
+            ssd1306_chart_segment(p, w, i);
+        w->chart.pushed=0;
+        break;
+    case SSD1306_WIDGET_SELECTOR: {
+        char text[SSD1306_WIDGET_TEXT_LEN];
+
+        for(uint8_t i=0; i<w->selector.count; ++i) {
+            const char *item=w->selector.items[i];
+            if(i==w->selector.selected) {
+                snprintf(text, sizeof(text), "-> %s", item);
+                item=text;
+            }
+            w->draw_text(p, w->x, w->y+i*w->selector.row_height, w->width, 1, w->font, item, w->align, SSD1306_TEXT_ELLIPSIS);
+        }
+        break;
+    }
+    }
+}
+
+void ssd1306_screen_setup(ssd1306_screen_t *s, ssd1306_widget_t *widgets, uint8_t count) {
+    s->widgets=widgets;
+    s->count=count;
+    s->invalid=true;
+}
+
+inline void ssd1306_screen_invalidate(ssd1306_screen_t *s) {
+    s->invalid=true;
+}
+
+static void ssd1306_show_region_cb(void *ctx, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    (void) ctx;
+    ssd1306_show_region(p, x, y, width, height);
+}
+
+inline uint32_t ssd1306_screen_render(ssd1306_t *p, ssd1306_screen_t *s) {
+    return ssd1306_screen_render_with(p, s, ssd1306_show_region_cb, NULL);
+}
+
+uint32_t ssd1306_screen_render_with(ssd1306_t *p, ssd1306_screen_t *s, ssd1306_flush_fn flush, void *ctx) {
+    uint32_t drawn=0;
+
+    if(s->invalid) {
+        ssd1306_clear(p);
+        for(uint8_t i=0; i<s->count; ++i) {
+            ssd1306_widget_draw(p, &s->widgets[i]);
+            s->widgets[i].dirty=false;
+        }
+        flush(ctx, p, 0, 0, p->width, p->height);
+        s->invalid=false;
+        return s->count;
+    }
+
+    // column span touched on every page, merged over all dirty widgets
+    uint8_t span_start[SSD1306_WIDGET_MAX_PAGES], span_end[SSD1306_WIDGET_MAX_PAGES];
+    memset(span_start, 0xff, sizeof(span_start));
+    memset(span_end, 0, sizeof(span_end));
+
+    for(uint8_t i=0; i<s->count; ++i) {
+        ssd1306_widget_t *w=&s->widgets[i];
+        const bool pushed=w->type==SSD1306_WIDGET_CHART && w->chart.pushed;
+        if(!w->dirty && !pushed) continue;
+
+        if(w->dirty || !ssd1306_chart_scroll(p, w)) {
+            ssd1306_clear_square(p, w->x, w->y, w->width, w->height);
+            ssd1306_widget_draw(p, w);
+        }
+        w->dirty=false;
+        ++drawn;
+
+        if(w->x>=p->width || w->y>=p->height || !w->width || !w->height) continue;
+
+        uint32_t x_end=w->x+w->width-1, y_end=w->y+w->height-1;
+        if(x_end>=p->width) x_end=p->width-1;
+        if(y_end>=p->height) y_end=p->height-1;
+
+        for(uint32_t pg=w->y>>3; pg<=(y_end>>3) && pg<SSD1306_WIDGET_MAX_PAGES; ++pg) {
+            if(w->x<span_start[pg]) span_start[pg]=w->x;
+            if(x_end>span_end[pg]) span_end[pg]=x_end;
+        }
+    }
+
+    for(uint32_t pg=0; pg<p->pages && pg<SSD1306_WIDGET_MAX_PAGES; ++pg) {
+        if(span_start[pg]>span_end[pg]) continue;
+
+        // send runs of pages with the same span in one go
+        uint32_t last=pg;
+        while(last+1<p->pages && last+1<SSD1306_WIDGET_MAX_PAGES && span_start[last+1]==span_start[pg] && span_end[last+1]==span_end[pg])
+            ++last;
+
+        flush(ctx, p, span_start[pg], pg<<3, span_end[pg]-span_start[pg]+1, (last-pg+1)<<3);
+        pg=last;
+    }
+
+    return drawn;
+}
@@ -0,0 +1,248 @@
+/**
+* @file ssd1306_widget.h
+*
+* retained-mode widgets for ssd1306 displays
+*
+* a widget owns a bounding box on the display and the value it shows. setting a
+* value only marks the widget dirty when its drawn representation changes, and
+* ssd1306_screen_render redraws and sends just the dirty widgets.
+*/
+
+#ifndef _inc_ssd1306_widget
+#define _inc_ssd1306_widget
+#include "ssd1306.h"
+
+#ifndef SSD1306_WIDGET_TEXT_LEN
+#define SSD1306_WIDGET_TEXT_LEN 24
+#endif
+
+/**
+*	@brief kinds of widgets
+*/
+typedef enum {
+    SSD1306_WIDGET_LABEL,		/**< constant text */
+    SSD1306_WIDGET_NUMBER,		/**< number formatted with a printf format */
+    SSD1306_WIDGET_BAR,			/**< horizontal bar filled proportionally to a value */
+    SSD1306_WIDGET_CHART,		/**< line chart of an array of values */
+    SSD1306_WIDGET_SELECTOR		/**< list of items, the selected one marked with "-> " */
+} ssd1306_widget_type_t;
+
+/**
+*	@brief draws the text of text widgets, same parameters as ssd1306_draw_string_aligned
+*/
+typedef uint32_t (*ssd1306_text_fn)(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t scale, const uint8_t *font, const char *s, ssd1306_align_t align, uint32_t flags);
+
+/**
+*	@brief a widget, set up with one of the ssd1306_*_setup functions
+*/
+typedef struct {
+    ssd1306_widget_type_t type;
+    uint8_t x;					/**< bounding box, cleared before the widget is drawn */
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+    bool dirty;					/**< whether the widget has to be redrawn */
+    const uint8_t *font;		/**< font of text widgets, font_8x5 by default */
+    ssd1306_text_fn draw_text;	/**< ssd1306_draw_string_aligned by default, e.g. ssd1306_utf8_text for utf-8 text */
+    ssd1306_align_t align;		/**< alignment of text inside the bounding box */
+    union {
+        struct {
+            const char *text;
+        } label;
+        struct {
+            const char *fmt;
+            char text[SSD1306_WIDGET_TEXT_LEN];	/**< last formatted value */
+        } number;
+        struct {
+            float max;
+            uint8_t fill;						/**< filled width in pixels */
+        } bar;
+        struct {
+            float *values;						/**< bound ring buffer, oldest value at head */
+            uint8_t count;
+            uint8_t head;
+            uint8_t pushed;						/**< values pushed since the last render */
+            float max;
+        } chart;
+        struct {
+            const char *const *items;
+            uint8_t count;
+            uint8_t selected;
+            uint8_t row_height;
+        } selector;
+    };
+} ssd1306_widget_t;
+
+/**
+*	@brief a set of widgets shown together
+*
+*	the bounding boxes of the widgets must not overlap, a redrawn widget clears its box
+*/
+typedef struct {
+    ssd1306_widget_t *widgets;
+    uint8_t count;
+    bool invalid;				/**< whether the whole display has to be cleared and sent */
+} ssd1306_screen_t;
+
+/**
+	@brief set up label widget
+
+	@param[out] w : widget to set up
+	@param[in] x : x position of the box
+	@param[in] y : y position of the box
+	@param[in] width : width of the box
+	@param[in] text : text, must stay valid and unchanged while shown
+	@param[in] align : alignment of the text inside the box
+*/
+void ssd1306_label_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, const char *text, ssd1306_align_t align);
+
+/**
+	@brief set up numeric field
+
+	@param[out] w : widget to set up
+	@param[in] x : x position of the box
+	@param[in] y : y position of the box
+	@param[in] width : width of the box
+	@param[in] fmt : printf format with a single double conversion
+	@param[in] align : alignment of the text inside the box
+*/
+void ssd1306_number_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, const char *fmt, ssd1306_align_t align);
+
+/**
+	@brief set up horizontal bar
+
+	@param[out] w : widget to set up
+	@param[in] x : x position of the bar
+	@param[in] y : y position of the bar
+	@param[in] width : width of the bar at max
+	@param[in] height : height of the bar
+	@param[in] max : value of a full bar
+*/
+void ssd1306_bar_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, float max);
+
+/**
+	@brief set up line chart
+
+	the oldest value is drawn at the left edge, the newest one at the right edge.
+	values are clamped to 0..max
+
+	@param[out] w : widget to set up
+	@param[in] x : x position of the chart
+	@param[in] y : y position of the chart
+	@param[in] width : width of the chart
+	@param[in] height : height of the chart, max is drawn at the top
+	@param[in] values : values to draw, oldest first; used as ring buffer by ssd1306_chart_push
+	@param[in] count : number of values, at least 2
+	@param[in] max : value drawn at the top edge
+*/
+void ssd1306_chart_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, float *values, uint8_t count, float max);
+
+/**
+	@brief set up selector
+
+	@param[out] w : widget to set up
+	@param[in] x : x position of the box
+	@param[in] y : y position of the first item
+	@param[in] width : width of the box
+	@param[in] row_height : distance between items
+	@param[in] items : texts of the items, must stay valid while shown
+	@param[in] count : number of items
+*/
+void ssd1306_selector_setup(ssd1306_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t row_height, const char *const *items, uint8_t count);
+
+/**
+	@brief change text of a label
+
+	@param[in] w : label widget
+	@param[in] text : new text, must stay valid and unchanged while shown
+*/
+void ssd1306_label_set(ssd1306_widget_t *w, const char *text);
+
+/**
+	@brief change value of a numeric field, dirty only if the formatted text changes
+
+	@param[in] w : numeric field
+	@param[in] value : new value
+*/
+void ssd1306_number_set(ssd1306_widget_t *w, float value);
+
+/**
+	@brief change value of a bar, dirty only if the filled width changes
+
+	@param[in] w : bar widget
+	@param[in] value : new value, clamped to 0..max
+*/
+void ssd1306_bar_set(ssd1306_widget_t *w, float value);
+
+/**
+	@brief append a value to a chart, dropping the oldest one
+
+	the next ssd1306_screen_render shifts the drawn chart to the left and only
+	draws the new segments, instead of redrawing the whole chart
+
+	@param[in] w : chart widget
+	@param[in] value : new value
+*/
+void ssd1306_chart_push(ssd1306_widget_t *w, float value);
+
+/**
+	@brief change selected item of a selector
+
+	@param[in] w : selector widget
+	@param[in] selected : index of the selected item
+*/
+void ssd1306_selector_set(ssd1306_widget_t *w, uint8_t selected);
+
+/**
+	@brief mark widget dirty, e.g. after the values bound to a chart changed
+
+	@param[in] w : widget
+*/
+void ssd1306_widget_invalidate(ssd1306_widget_t *w);
+
+/**
+	@brief set up screen
+
+	@param[out] s : screen to set up
+	@param[in] widgets : widgets of the screen, must stay valid
+	@param[in] count : number of widgets
+*/
+void ssd1306_screen_setup(ssd1306_screen_t *s, ssd1306_widget_t *widgets, uint8_t count);
+
+/**
+	@brief redraw the whole screen on the next ssd1306_screen_render, e.g. when switching to it
+
+	@param[in] s : screen
+*/
+void ssd1306_screen_invalidate(ssd1306_screen_t *s);
+
+/**
+	@brief redraw dirty widgets and send the changed regions to the display
+
+	@param[in] p : instance of display
+	@param[in] s : screen
+
+	@return number of widgets redrawn
+*/
+uint32_t ssd1306_screen_render(ssd1306_t *p, ssd1306_screen_t *s);
+
+/**
+*	@brief receives the regions changed by ssd1306_screen_render_with
+*/
+typedef void (*ssd1306_flush_fn)(void *ctx, ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief redraw dirty widgets and pass the changed regions to a flush function
+
+	e.g. ssd1306_manager_flush_cb to queue them with a display manager
+
+	@param[in] p : instance of display
+	@param[in] s : screen
+	@param[in] flush : called for every changed region instead of ssd1306_show_region
+	@param[in] ctx : passed to flush
+
+	@return number of widgets redrawn
+*/
+uint32_t ssd1306_screen_render_with(ssd1306_t *p, ssd1306_screen_t *s, ssd1306_flush_fn flush, void *ctx);
+
+#endif
@@ -0,0 +1,115 @@
+/**
+* @file bench_draw.c
+*
+* host timing of the drawing primitives
+*
+* every primitive runs on a 128x64 display driven through the mock transport
+* and the fastest of ROUNDS rounds is printed in ns per call, so rendering
+* changes can be compared on a PC before trying them on the Pico.
+*
+* bench_draw_fixed is the same program built with SSD1306_FIXED_WIDTH and
+* SSD1306_FIXED_HEIGHT, comparing both shows what the constant geometry saves.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+
+#define ROUNDS 20
+#define CALLS 2000		// per round
+
+static ssd1306_t disp;
+static ssd1306_mock_t mock;
+static uint32_t counter;
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e9+t.tv_nsec;
+}
+
+static void bench(const char *name, void (*draw)(void)) {
+    double best=0;
+    for(uint32_t r=0; r<ROUNDS; ++r) {
+        double t=now_ns();
+        for(uint32_t i=0; i<CALLS; ++i) {
+            draw();
+            ++counter;
+        }
+        t=(now_ns()-t)/CALLS;
+        if(r==0 || t<best)
+            best=t;
+    }
+    printf("%-32s %10.1f ns\n", name, best);
+}
+
+// a 32x32 native image, top half set by main
+static uint8_t image[SSD1306_IMG_HEADER_SIZE+32*4]= {SSD1306_IMG_MAGIC, 0, 32, 32};
+static const uint8_t columns[16]= {0x3c, 0x42, 0x81, 0x81, 0x81, 0x81, 0x42, 0x3c, 0x18, 0x24, 0x42, 0x81, 0x81, 0x42, 0x24, 0x18};
+static uint8_t prev[128*8];
+
+// x and y walk over the display so the unaligned cases are timed too
+#define X (counter%96)
+#define Y (counter%48)
+
+static void draw_pixel(void) { ssd1306_draw_pixel(&disp, counter&127, (counter>>7)&63); }
+static void clear_pixel(void) { ssd1306_clear_pixel(&disp, counter&127, (counter>>7)&63); }
+static void draw_line(void) { ssd1306_draw_line(&disp, 0, Y, 127, 63-Y); }
+static void draw_square(void) { ssd1306_draw_square(&disp, X, Y, 32, 16); }
+static void clear_square(void) { ssd1306_clear_square(&disp, X, Y, 32, 16); }
+static void draw_empty_square(void) { ssd1306_draw_empty_square(&disp, X, Y, 31, 15); }
+static void invert_region(void) { ssd1306_invert_region(&disp, X, Y, 32, 16); }
+static void scroll_region_left(void) { ssd1306_scroll_region_left(&disp, 0, Y, 128, 16, 1); }
+static void clear(void) { ssd1306_clear(&disp); }
+static void fill_pattern(void) { ssd1306_fill_pattern(&disp, 0x55aa55aa); }
+static void combine(void) { ssd1306_combine(&disp, prev, SSD1306_COMBINE_OR); }
+static void diff(void) { uint8_t start[8], end[8]; ssd1306_diff(&disp, prev, start, end); }
+static void draw_image(void) { ssd1306_draw_image(&disp, X, Y, image); }
+static void copy_image(void) { ssd1306_copy_image(&disp, X, Y, image); }
+static void blit_columns(void) { ssd1306_blit_columns(&disp, X, Y, columns, 16, 1, 1); }
+static void draw_char(void) { ssd1306_draw_char(&disp, X, Y, 1, 'A'+(counter%26)); }
+static void draw_char_scale2(void) { ssd1306_draw_char(&disp, X, Y, 2, 'A'+(counter%26)); }
+static void draw_string(void) { ssd1306_draw_string(&disp, 0, Y, 1, "Ocupacao: 81.2%"); }
+static void draw_string_aligned(void) { ssd1306_draw_string_aligned(&disp, 0, Y, 128, 1, font_8x5, "Distancia: 22.5 cm", SSD1306_ALIGN_CENTER, SSD1306_TEXT_CONST); }
+static void show(void) { ssd1306_show(&disp); }
+static void show_region(void) { ssd1306_show_region(&disp, X, Y, 32, 16); }
+
+int main(void) {
+    memset(image+SSD1306_IMG_HEADER_SIZE, 0xff, 32*2);
+    ssd1306_mock_setup(&mock);
+    if(!ssd1306_init_with_transport(&disp, 128, 64, &ssd1306_transport_mock, &mock)) {
+        printf("cannot init display\n");
+        return 1;
+    }
+
+#ifdef SSD1306_FIXED_WIDTH
+    printf("fixed geometry %ux%u\n", SSD1306_FIXED_WIDTH, SSD1306_FIXED_HEIGHT);
+#else
+    printf("runtime geometry %ux%u\n", ssd1306_width(&disp), ssd1306_height(&disp));
+#endif
+    bench("ssd1306_draw_pixel", draw_pixel);
+    bench("ssd1306_clear_pixel", clear_pixel);
+    bench("ssd1306_draw_line", draw_line);
+    bench("ssd1306_draw_square 32x16", draw_square);
+    bench("ssd1306_clear_square 32x16", clear_square);
+    bench("ssd1306_draw_empty_square", draw_empty_square);
+    bench("ssd1306_invert_region 32x16", invert_region);
+    bench("ssd1306_scroll_region_left", scroll_region_left);
+    bench("ssd1306_clear", clear);
+    bench("ssd1306_fill_pattern", fill_pattern);
+    bench("ssd1306_combine", combine);
+    bench("ssd1306_diff", diff);
+    bench("ssd1306_draw_image 32x32", draw_image);
+    bench("ssd1306_copy_image 32x32", copy_image);
+    bench("ssd1306_blit_columns 16", blit_columns);
+    bench("ssd1306_draw_char", draw_char);
+    bench("ssd1306_draw_char scale 2", draw_char_scale2);
+    bench("ssd1306_draw_string", draw_string);
+    bench("ssd1306_draw_string_aligned", draw_string_aligned);
+    bench("ssd1306_show", show);
+    bench("ssd1306_show_region 32x16", show_region);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+* @file bench_glyph.c
+*
+* host timing of the CP0-EU code point lookup of ssd1306_utf8.c
+*
+* the reference scans CHARMAP_CP0_EU for every code point, the way get_CP0_EU
+* did before CP0_EU_lookup.h was generated. both must give the same glyph for
+* every code point below U+30000; the time per character is printed for long
+* multilingual text.
+*/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "ssd1306_utf8.h"
+#include "CP0_EU_8x8.h"
+#include "utf-8.h"
+
+#define ROUNDS 10
+#define CODEPOINTS (1<<18)
+
+static const char text[]=
+    "Ζαφείρι δέξου πάγκαλο, βαθῶν ψυχῆς τὸ σῆμα. "
+    "Příliš žluťoučký kůň úpěl ďábelské ódy. "
+    "Zażółć gęślą jaźń. "
+    "Árvíztűrő tükörfúrógép. "
+    "Voix ambiguë d'un cœur qui au zéphyr préfère les jattes de kiwis — 5 € … "
+    "The quick brown fox jumps over the lazy dog. ";
+
+static uint32_t codepoints[CODEPOINTS];
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e9+t.tv_nsec;
+}
+
+static uint8_t reference_glyph(uint32_t codepoint) {
+    for(uint32_t i=0; i<256; ++i)
+        if(CHARMAP_CP0_EU[i]==codepoint)
+            return i;
+    return ssd1306_utf8_glyph(0x2022);		// the bullet drawn for missing code points
+}
+
+// ns per code point of one round
+static double time_lookup(uint32_t n, bool reference) {
+    volatile uint32_t sink=0;
+    double t=now_ns();
+    for(uint32_t i=0; i<n; ++i)
+        sink+=reference?reference_glyph(codepoints[i]):ssd1306_utf8_glyph(codepoints[i]);
+    (void) sink;
+    return (now_ns()-t)/n;
+}
+
+int main(void) {
+    for(uint32_t cp=0; cp<0x30000; ++cp) {
+        if(reference_glyph(cp)!=ssd1306_utf8_glyph(cp)) {
+            printf("U+%04X: glyph differs from the reference\n", cp);
+            return 1;
+        }
+    }
+
+    uint32_t n=0;
+    utf8_iter iter;
+    while(n<CODEPOINTS-sizeof(text)) {
+        utf8_init(&iter, text);
+        while(utf8_next(&iter))
+            codepoints[n++]=iter.codepoint;
+    }
+
+    // the rounds alternate, so both see the same clock speed; the fastest of each is kept
+    double reference=0, table=0;
+    for(uint32_t r=0; r<ROUNDS; ++r) {
+        const double t_reference=time_lookup(n, true), t_table=time_lookup(n, false);
+        if(r==0 || t_reference<reference)
+            reference=t_reference;
+        if(r==0 || t_table<table)
+            table=t_table;
+    }
+    printf("ssd1306_utf8_glyph, %u code points: %6.2f ns, linear scan %6.1f ns, %5.1fx\n", n, table, reference, reference/table);
+    return 0;
+}
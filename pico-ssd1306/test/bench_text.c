@@ -0,0 +1,111 @@
+/**
+* @file bench_text.c
+*
+* host timing of text drawing against the per-pixel renderer
+*
+* the reference draws every set bit of a glyph as a scale x scale square of
+* ssd1306_draw_pixel calls, the way text was drawn before glyph columns were
+* blitted as page bytes. both must leave the same buffer; the speedup of
+* ssd1306_draw_string is printed for every scale.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+
+#define ROUNDS 20
+#define CALLS 500		// per round
+
+static const char sentence[]="Ocupacao: 81.2% Distancia: 22.5 cm";
+static char text[sizeof(sentence)];		// as much of sentence as fits the display
+
+static ssd1306_t disp;
+static ssd1306_mock_t mock;
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e9+t.tv_nsec;
+}
+
+static void reference_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+    if(c<font[3]||c>font[4])
+        return;
+
+    uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
+    for(uint8_t w=0; w<font[1]; ++w) {
+        uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
+        for(uint32_t lp=0; lp<parts_per_line; ++lp) {
+            uint8_t line=font[pp];
+
+            for(int8_t j=0; j<8; ++j, line>>=1) {
+                if(line & 1) {
+                    for(uint32_t i=0; i<scale; ++i)
+                        for(uint32_t k=0; k<scale; ++k)
+                            ssd1306_draw_pixel(p, x+w*scale+i, y+((lp<<3)+j)*scale+k);
+                }
+            }
+
+            ++pp;
+        }
+    }
+}
+
+static void reference_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s) {
+    for(int32_t x_n=x; *s; x_n+=(font[1]+font[2])*scale) {
+        reference_draw_char(p, x_n, y, scale, font, *(s++));
+    }
+}
+
+// ns per call of one round, y moves so unaligned rows are timed too
+static double time_string(uint32_t scale, bool reference) {
+    double t=now_ns();
+    for(uint32_t i=0; i<CALLS; ++i) {
+        if(reference)
+            reference_draw_string(&disp, 0, i&15, scale, font_8x5, text);
+        else
+            ssd1306_draw_string(&disp, 0, i&15, scale, text);
+    }
+    return (now_ns()-t)/CALLS;
+}
+
+int main(void) {
+    ssd1306_mock_setup(&mock);
+    if(!ssd1306_init_with_transport(&disp, 128, 64, &ssd1306_transport_mock, &mock)) {
+        printf("cannot init display\n");
+        return 1;
+    }
+
+    static uint8_t expected[128*8];
+    for(uint32_t scale=1; scale<=3; ++scale) {
+        const uint32_t fits=ssd1306_width(&disp)/((font_8x5[1]+font_8x5[2])*scale);
+        snprintf(text, sizeof(text), "%.*s", (int) fits, sentence);
+
+        for(uint32_t y=0; y<16; ++y) {
+            ssd1306_clear(&disp);
+            reference_draw_string(&disp, 0, y, scale, font_8x5, text);
+            memcpy(expected, ssd1306_buffer(&disp), ssd1306_bufsize(&disp));
+            ssd1306_clear(&disp);
+            ssd1306_draw_string(&disp, 0, y, scale, text);
+            if(memcmp(expected, ssd1306_buffer(&disp), ssd1306_bufsize(&disp))) {
+                printf("scale %u, y %u: text differs from the reference\n", scale, y);
+                return 1;
+            }
+        }
+
+        // the rounds alternate, so both see the same clock speed; the fastest of each is kept
+        double reference=0, blit=0;
+        for(uint32_t r=0; r<ROUNDS; ++r) {
+            const double t_reference=time_string(scale, true), t_blit=time_string(scale, false);
+            if(r==0 || t_reference<reference)
+                reference=t_reference;
+            if(r==0 || t_blit<blit)
+                blit=t_blit;
+        }
+        printf("ssd1306_draw_string scale %u, %2u chars: %8.1f ns, per pixel %8.1f ns, %5.1fx\n", scale, fits, blit, reference, reference/blit);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+* @file test_telas.c
+*
+* golden image test of the SMIL screens (smil_telas.c)
+*
+* every SecaoDisplay and the compartment screen are rendered for a sequence of
+* SistemaLixeira states, each on its own display driven through the mock
+* transport, the way smil.c does: a screen is redrawn in full when it replaces
+* another one, otherwise only the changed widgets are sent. what every panel
+* shows is written as pbm and compared byte by byte with golden/<state>_<screen>.pbm.
+* a fresh full redraw must match the partial updates as well.
+*
+* usage: test_telas <golden dir> [update]
+* with update the goldens are rewritten instead of compared.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+#include "smil_telas.h"
+
+#define SCREENS 5		// the four sections and the compartment
+
+typedef struct {
+    const char *name;
+    SistemaLixeira state;
+} state_t;
+
+// in the order smil.c would go through them, trends are pushed once per state
+static const state_t states[]= {
+    {"desligado", {.funcionando=false, .modoNoturnoAtivado=true}},
+    {"vazia", {.funcionando=true, .modoNoturnoAtivado=true, .distancia=120.0f, .ocupacao=0.0f}},
+    {"metade", {.funcionando=true, .modoNoturnoAtivado=false, .distancia=60.0f, .ocupacao=50.0f}},
+    {"alta", {.funcionando=true, .modoNoturnoAtivado=false, .distancia=22.5f, .ocupacao=81.25f}},
+    {"cheia", {.funcionando=true, .modoNoturnoAtivado=true, .distancia=3.5f, .ocupacao=97.1f}},
+};
+
+static const char *const screen_names[SCREENS]= {"principal", "graficos", "tendencias", "modo", "compartimento"};
+
+SistemaLixeira sistema;
+
+static ssd1306_screen_t *screen_for(uint32_t screen) {
+    return screen<SCREENS-1?displaySecao((SecaoDisplay) screen):displayTelaCompartimento();
+}
+
+static bool read_file(const char *path, uint8_t *data, size_t *len) {
+    FILE *f=fopen(path, "rb");
+    if(f==NULL)
+        return false;
+    *len=fread(data, 1, *len, f);
+    fclose(f);
+    return true;
+}
+
+// writes what the mock shows to path and compares it with the golden of the same name
+static bool check_golden(const ssd1306_mock_t *mock, const char *golden_dir, const char *name, bool update) {
+    char path[512], golden[512];
+    snprintf(path, sizeof(path), "%s.pbm", name);
+    snprintf(golden, sizeof(golden), "%s/%s.pbm", golden_dir, name);
+
+    if(!ssd1306_mock_write_pbm(mock, SCREEN_WIDTH, SCREEN_HEIGHT, update?golden:path)) {
+        printf("%s: cannot write\n", update?golden:path);
+        return false;
+    }
+    if(update)
+        return true;
+
+    uint8_t expected[2048], actual[2048];
+    size_t expected_len=sizeof(expected), actual_len=sizeof(actual);
+    if(!read_file(golden, expected, &expected_len)) {
+        printf("%s: missing golden %s\n", name, golden);
+        return false;
+    }
+    read_file(path, actual, &actual_len);
+    if(expected_len!=actual_len || memcmp(expected, actual, actual_len)) {
+        printf("%s: differs from %s, see %s\n", name, golden, path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if(argc<2) {
+        printf("usage: %s <golden dir> [update]\n", argv[0]);
+        return 2;
+    }
+    const bool update=argc>2 && !strcmp(argv[2], "update");
+
+    ssd1306_mock_t mocks[SCREENS], fresh_mock;
+    ssd1306_t displays[SCREENS], fresh;
+    ssd1306_screen_t *shown[SCREENS]= {NULL};
+    for(uint32_t i=0; i<SCREENS; ++i) {
+        ssd1306_mock_setup(&mocks[i]);
+        if(!ssd1306_init_with_transport(&displays[i], SCREEN_WIDTH, SCREEN_HEIGHT, &ssd1306_transport_mock, &mocks[i])) {
+            printf("cannot init display\n");
+            return 1;
+        }
+    }
+    ssd1306_mock_setup(&fresh_mock);
+    ssd1306_init_with_transport(&fresh, SCREEN_WIDTH, SCREEN_HEIGHT, &ssd1306_transport_mock, &fresh_mock);
+
+    inicializarTelas();
+
+    uint32_t failures=0;
+    for(uint32_t s=0; s<sizeof(states)/sizeof(states[0]); ++s) {
+        sistema=states[s].state;
+        if(sistema.funcionando)
+            atualizarTendencias(sistema.ocupacao);
+
+        for(uint32_t i=0; i<SCREENS; ++i) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s_%s", states[s].name, screen_names[i]);
+
+            ssd1306_screen_t *screen=screen_for(i);
+            if(screen!=shown[i]) {
+                ssd1306_screen_invalidate(screen);
+                shown[i]=screen;
+            }
+            ssd1306_screen_render(&displays[i], screen);
+            if(!check_golden(&mocks[i], argv[1], name, update))
+                ++failures;
+
+            // partial updates must leave the panel as a full redraw would
+            ssd1306_screen_invalidate(screen);
+            ssd1306_screen_render(&fresh, screen);
+            if(memcmp(fresh_mock.ram, mocks[i].ram, sizeof(fresh_mock.ram))) {
+                printf("%s: partial update differs from a full redraw\n", name);
+                ++failures;
+            }
+        }
+    }
+
+    if(failures) {
+        printf("%u failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
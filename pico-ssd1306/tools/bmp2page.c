@@ -0,0 +1,220 @@
+/*
+ * converts a monochrome bmp into the native page-major image format of
+ * ssd1306_draw_image/ssd1306_copy_image and writes it as a c array
+ *
+ * format: 'P', flags, width, height, data
+ * data is one byte per column and page (bit 0 is the top row), page after page.
+ * with SSD1306_IMG_RLE (flags bit 0) the data is packed into runs:
+ * a control byte c<0x80 is followed by c+1 literal bytes,
+ * c>=0x80 by one byte that is repeated (c&0x7f)+1 times.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define IMG_MAGIC 'P'
+#define IMG_RLE 0x01
+#define MAX_RUN 128
+
+void normalize_name(char *name) {
+    for(size_t i=0; name[i]!=0; ++i) {
+        if(!(('a'<=name[i]&&name[i]<='z')||('A'<=name[i]&&name[i]<='Z')||('0'<=name[i]&&name[i]<='9')))
+            name[i]='_';
+    }
+}
+
+static uint32_t get_val(const uint8_t *data, size_t offset, uint8_t size) {
+    uint32_t v=0;
+    for(uint8_t i=0; i<size; ++i)
+        v|=(uint32_t) data[offset+i]<<(8*i);
+    return v;
+}
+
+// returns page-major image data or NULL, sets width and height
+static uint8_t *bmp_to_pages(const uint8_t *data, size_t size, uint32_t *width, uint32_t *height) {
+    if(size<54 || data[0]!='B' || data[1]!='M') {
+        fprintf(stderr, "not a bmp file!\n");
+        return NULL;
+    }
+
+    const uint32_t bfOffBits=get_val(data, 10, 4);
+    const uint32_t biSize=get_val(data, 14, 4);
+    const uint32_t biWidth=get_val(data, 18, 4);
+    const int32_t biHeight=(int32_t) get_val(data, 22, 4);
+    const uint16_t biBitCount=(uint16_t) get_val(data, 28, 2);
+    const uint32_t biCompression=get_val(data, 30, 4);
+    const uint32_t h=biHeight>0?biHeight:-biHeight;
+
+    if(biBitCount!=1 || biCompression!=0) {
+        fprintf(stderr, "image must be monochrome and uncompressed!\n");
+        return NULL;
+    }
+
+    if(biWidth==0 || biWidth>255 || h==0 || h>255) {
+        fprintf(stderr, "image must be between 1x1 and 255x255 pixels!\n");
+        return NULL;
+    }
+
+    uint32_t bytes_per_line=(biWidth/8)+(biWidth&7?1:0);
+    if(bytes_per_line&3)
+        bytes_per_line=(bytes_per_line^(bytes_per_line&3))+4;
+
+    if(bfOffBits+bytes_per_line*h>size || 14+biSize+8>size) {
+        fprintf(stderr, "bmp file truncated!\n");
+        return NULL;
+    }
+
+    // pixels with the black palette entry are drawn, like ssd1306_bmp_show_image does
+    const uint32_t table_start=14+biSize;
+    uint8_t color_val=0;
+    for(uint8_t i=0; i<2; ++i) {
+        if(!((data[table_start+i*4]<<16)|(data[table_start+i*4+1]<<8)|data[table_start+i*4+2])) {
+            color_val=i;
+            break;
+        }
+    }
+
+    const uint32_t pages=(h+7)/8;
+    uint8_t *out=calloc(pages*biWidth, 1);
+    if(out==NULL)
+        return NULL;
+
+    for(uint32_t row=0; row<h; ++row) {
+        // bottom-up unless the height is negative
+        const uint32_t y=biHeight>0?h-1-row:row;
+        const uint8_t *line=data+bfOffBits+row*bytes_per_line;
+
+        for(uint32_t x=0; x<biWidth; ++x) {
+            if(((line[x>>3]>>(7-(x&7)))&1)==color_val)
+                out[(y>>3)*biWidth+x]|=1<<(y&7);
+        }
+    }
+
+    *width=biWidth;
+    *height=h;
+    return out;
+}
+
+// packs src into runs, dst must hold len+len/MAX_RUN+1 bytes; returns packed size
+static size_t rle_pack(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t o=0, i=0;
+
+    while(i<len) {
+        size_t run=1;
+        while(i+run<len && run<MAX_RUN && src[i+run]==src[i])
+            ++run;
+
+        if(run>=3) {
+            dst[o++]=0x80|(run-1);
+            dst[o++]=src[i];
+            i+=run;
+            continue;
+        }
+
+        // literals up to the next run of three
+        size_t lit=0;
+        while(i+lit<len && lit<MAX_RUN) {
+            if(i+lit+2<len && src[i+lit]==src[i+lit+1] && src[i+lit]==src[i+lit+2])
+                break;
+            ++lit;
+        }
+
+        dst[o++]=lit-1;
+        memcpy(dst+o, src+i, lit);
+        o+=lit;
+        i+=lit;
+    }
+
+    return o;
+}
+
+static void write_array(FILE *out, const char *name, const uint8_t *header, const uint8_t *data, size_t len) {
+    fprintf(out, "const unsigned long %s_img_size=%lu;\n", name, (unsigned long) len+4);
+    fprintf(out, "const unsigned char %s_img[]={\n", name);
+    fprintf(out, "0x%02x,0x%02x,0x%02x,0x%02x,\n", header[0], header[1], header[2], header[3]);
+
+    for(size_t i=0; i<len; ++i) {
+        fprintf(out, i+1<len?"0x%02x,":"0x%02x", data[i]);
+        if((i&15)==15)
+            fprintf(out, "\n");
+    }
+    fprintf(out, "\n};\n");
+}
+
+int main(int ac, char *as[]) {
+    int rle=0;
+
+    if(ac>1 && strcmp(as[1], "-r")==0) {
+        rle=1;
+        --ac;
+        ++as;
+    }
+
+    if(ac<2||ac>3) {
+        fprintf(stderr, "Usage: %s [-r] [input bmp] [output file?]\n", as[0]);
+        fprintf(stderr, "\t-r: compress image data with run-length encoding\n");
+        return EXIT_FAILURE;
+    }
+
+    FILE *in=NULL, *out=NULL;
+    uint8_t *data=NULL, *pages=NULL, *packed=NULL;
+    char *norm_name=NULL;
+    int ret=EXIT_FAILURE;
+
+    if((in=fopen(as[1], "rb"))==NULL) {
+        fprintf(stderr, "Could not open \"%s\" for reading!\n", as[1]);
+        goto end;
+    }
+
+    fseek(in, 0, SEEK_END);
+    size_t file_size=ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    if((data=malloc(file_size))==NULL || fread(data, 1, file_size, in)!=file_size) {
+        fprintf(stderr, "Could not read \"%s\"!\n", as[1]);
+        goto end;
+    }
+
+    uint32_t width, height;
+    if((pages=bmp_to_pages(data, file_size, &width, &height))==NULL)
+        goto end;
+
+    if(ac==3) {
+        if((out=fopen(as[2], "w"))==NULL) {
+            fprintf(stderr, "Could not open \"%s\" for writing!\n", as[2]);
+            goto end;
+        }
+    } else
+        out=stdout;
+
+    norm_name=strdup(as[1]);
+    normalize_name(norm_name);
+
+    const size_t raw_len=((height+7)/8)*width;
+    uint8_t header[4]= {IMG_MAGIC, 0, width, height};
+
+    if(rle) {
+        if((packed=malloc(raw_len+raw_len/MAX_RUN+1))==NULL)
+            goto end;
+        size_t packed_len=rle_pack(pages, raw_len, packed);
+        header[1]|=IMG_RLE;
+        write_array(out, norm_name, header, packed, packed_len);
+        fprintf(stderr, "%ux%u: %lu bytes raw, %lu bytes packed\n", width, height, (unsigned long) raw_len, (unsigned long) packed_len);
+    } else
+        write_array(out, norm_name, header, pages, raw_len);
+
+    ret=EXIT_SUCCESS;
+
+end:
+    free(norm_name);
+    free(packed);
+    free(pages);
+    free(data);
+    if(in)
+        fclose(in);
+    if(out && out!=stdout)
+        fclose(out);
+    return ret;
+}
@@ -2,6 +2,9 @@
 #include "hardware/adc.h"
 #include "ws2812b_animation.h"
 #include "ssd1306.h"
+#include "smil_telas.h"
+#include "ssd1306_manager.h"
+#include "ssd1306_power.h"
 #include "hardware/i2c.h"
 #include <string.h>
 #include <stdio.h>
@@ -15,15 +18,11 @@
 #define JOYSTICK_VRX 27       /**< Pino X do joystick */
 #define JOYSTICK_VRY 26       /**< Pino Y do joystick */
 #define JOYSTICK_SW 22        /**< Pino do botão do joystick */
-#define SCREEN_WIDTH 128      /**< Largura da tela do display */
-#define SCREEN_HEIGHT 64      /**< Altura da tela do display */
 #define SCREEN_ADDRESS 0x3C   /**< Endereço I2C do display SSD1306 */
+#define SCREEN_ADDRESS_COMPARTIMENTO 0x3D  /**< Endereço I2C do display opcional do compartimento */
 #define I2C_SDA 14            /**< Pino SDA para comunicação I2C */
 #define I2C_SCL 15            /**< Pino SCL para comunicação I2C */
 
-#define ALTURA_MAX_LIXEIRA 120 /**< Altura máxima da lixeira em centímetros */
-#define MAX_MEASUREMENTS 10    /**< Número máximo de medições para as tendências */
-
 // Definição das constantes de leitura do joystick
 #define JOYSTICK_VRY_MAX 3500  /**< Valor máximo para o eixo Y do joystick */
 #define JOYSTICK_VRY_MIN 500   /**< Valor mínimo para o eixo Y do joystick */
@@ -32,31 +31,33 @@
 #define JOYSTICK_VRX_MAX 3500  /**< Valor máximo para o eixo X do joystick */
 #define JOYSTICK_VRX_MIN 500   /**< Valor mínimo para o eixo X do joystick */
 
-// Estrutura para representar o estado do sistema da lixeira
-typedef struct {
-    int brilho;               /**< Nível de brilho dos LEDs */
-    bool funcionando;         /**< Flag de funcionamento do sistema */
-    bool modoNoturnoAtivado;  /**< Flag do modo noturno ativado */
-    float distancia;          /**< Distância medida pelo sensor ultrassônico */
-    float ocupacao;           /**< Percentual de ocupação da lixeira */
-} SistemaLixeira;
-
-// Enumeração para representar as seções do display
-typedef enum {
-    SECAO_PRINCIPAL,  /**< Seção principal do display */
-    SECAO_GRAFICOS,   /**< Seção de gráficos do display */
-    SECAO_TENDENCIAS,  /**< Seção de tendências do display */
-    SECAO_MODO_NOTURNO, /**< Seção do modo noturno do display */
-} SecaoDisplay;
+// Brilho dos LEDs, de 0 (apagado) a 255 (máximo)
+#define BRILHO_INICIAL 16      /**< Brilho ao ligar a estação */
+#define BRILHO_PADRAO 4        /**< Brilho restaurado pelo botão do joystick */
+#define BRILHO_PASSO 8         /**< Variação do brilho a cada leitura do joystick */
+#define CORRENTE_LEDS_MA 300   /**< Corrente máxima da matriz de LEDs, com folga no regulador de 5 V para o buzzer */
+
+// Política de energia do display principal
+#define DISPLAY_ESCURECER_MS 30000   /**< Tempo sem entradas até reduzir o contraste */
+#define DISPLAY_DESLIGAR_MS 120000   /**< Tempo sem entradas até desligar o display */
+#define CONTRASTE_NORMAL 0xff        /**< Contraste do display ligado */
+#define CONTRASTE_ESCURECIDO 0x20    /**< Contraste do display escurecido */
+#define CONTRASTE_NOTURNO 0x30       /**< Contraste do display ligado no modo noturno */
+#define CONTRASTE_NOTURNO_ESCURECIDO 0x04  /**< Contraste do display escurecido no modo noturno */
 
 SecaoDisplay secaoAtual = SECAO_PRINCIPAL;  /**< Variável que armazena a seção atual do display, iniciando na seção principal */
+ssd1306_screen_t *telaAtual = NULL;  /**< Tela exibida atualmente no display */
 
 // Instância do Display SSD1306
 ssd1306_t display; /**< Inicializa a instância do display OLED */
+ssd1306_t displayCompartimento; /**< Display do compartimento, presente apenas nas estações maiores */
+bool compartimentoPresente = false; /**< Indica se o display do compartimento respondeu na inicialização */
+ssd1306_manager_t gerenciadorDisplays; /**< Agenda os envios dos displays que compartilham o barramento I2C */
+ssd1306_power_t energiaDisplay; /**< Escurece e desliga o display principal quando ninguém o usa */
 
 // Instância do sistema da lixeira com valores iniciais
 SistemaLixeira sistema = {
-    .brilho = 4,                /**< Nível inicial de brilho dos LEDs */
+    .brilho = BRILHO_INICIAL,   /**< Nível inicial de brilho dos LEDs */
     .funcionando = false,        /**< Indica se o sistema está em funcionamento */
     .modoNoturnoAtivado = true,  /**< Define se o modo noturno está ativado */
     .distancia = 0.0,            /**< Distância inicial medida pelo sensor ultrassônico */
@@ -114,6 +115,7 @@ float obterDistanciaMedia(int qtdLeituras) {
     for (int i = 0; i < qtdLeituras; i++) {
         soma += obterDistanciaCM();  
         sleep_ms(10);  /**< Espera 10 milissegundos entre as leituras */
+        ssd1306_manager_poll(&gerenciadorDisplays);  /**< Continua os envios pendentes aos displays enquanto mede */
     }
     return soma / qtdLeituras;  /**< Retorna a média das distâncias */
 }
@@ -149,221 +151,75 @@ void emitirAlertaSonoro() {
     }
 }
 
-// Vetor para armazenar as últimas medições de ocupação e distância
-float ocupacaoTrend[MAX_MEASUREMENTS];  /**< Vetor que armazena as últimas medições de ocupação da lixeira */
-
 /**
- * @brief Função para atualizar as medições de tendência.
+ * @brief Função para desenhar a seção atual no display principal.
  * 
- * A função desloca os valores antigos para a esquerda e adiciona a nova medição 
- * na última posição do vetor, garantindo que sempre contenha as medições mais recentes.
- * 
- * @param ocupacao Valor atual da ocupação a ser armazenado.
+ * Ao trocar de tela o display é redesenhado por inteiro; depois disso apenas os
+ * widgets alterados são enfileirados no gerenciador.
  */
-void atualizarTendencias(float ocupacao) {
-    // Move os valores antigos para a esquerda
-    for (int i = 0; i < MAX_MEASUREMENTS - 1; i++) {
-        ocupacaoTrend[i] = ocupacaoTrend[i + 1];
-    }
-    
-    // Adiciona as novas medições nas últimas posições
-    ocupacaoTrend[MAX_MEASUREMENTS - 1] = ocupacao;
-}
+void atualizarTelaPrincipal() {
+    ssd1306_screen_t *tela = displaySecao(secaoAtual);  /**< Atualiza a tela da seção atual */
+    if (tela == NULL) return;
 
-
-/**
- * @brief Função para desenhar o gráfico de tendência no display.
- * 
- * A função desenha um gráfico que representa a variação da ocupação ao longo das medições recentes,
- * permitindo visualizar tendências de uso da lixeira.
- */
-void displayGraficoTendencia() {
-    int posX = 10;  /**< Posição inicial no eixo X para o gráfico */
-    int posYTexto = 5;  /**< Posição vertical do texto acima do gráfico */
-    char tituloTendencia[] = "Ocupacao Tendencias"; /**< Texto do título do gráfico de tendência */
-    int textoLargura = strlen(tituloTendencia) * 6;  /**< Calcula a largura do título assumindo 6 pixels por caractere */
-    int posXTexto = (SCREEN_WIDTH - textoLargura) / 2;  /**< Centraliza o título no eixo X */
-
-    uint32_t scale = 1;  /**< Escala do texto (1 é o tamanho normal) */
-    ssd1306_draw_string(&display, posXTexto, posYTexto, scale, tituloTendencia);  /**< Desenha o título no display */
-
-    // Posição inicial do gráfico logo abaixo do título
-    int alturaMaxima = SCREEN_HEIGHT - (posYTexto + 10);  /**< Define a altura máxima do gráfico abaixo do título */
-    int larguraGrafico = SCREEN_WIDTH - 20;  /**< Define a largura do gráfico */
-
-    // Desenha a linha de tendência para a ocupação
-    for (int i = 1; i < MAX_MEASUREMENTS; i++) {
-        int x1 = (i - 1) * (larguraGrafico / (MAX_MEASUREMENTS - 1)) + posX;  /**< Calcula a posição X do ponto anterior */
-        int x2 = i * (larguraGrafico / (MAX_MEASUREMENTS - 1)) + posX;  /**< Calcula a posição X do ponto atual */
-        
-        // Calcula a altura da linha (ocupação)
-        int y1 = alturaMaxima - (int)(ocupacaoTrend[i - 1] / 100.0 * alturaMaxima);  /**< Converte ocupação em altura */
-        int y2 = alturaMaxima - (int)(ocupacaoTrend[i] / 100.0 * alturaMaxima);  /**< Converte ocupação em altura */
-        
-        // Desenha a linha entre os pontos (x1, y1) e (x2, y2)
-        ssd1306_draw_line(&display, x1, y1 + posYTexto + 10, x2, y2 + posYTexto + 10);  /**< Desenha a linha da tendência de ocupação */
+    if (tela != telaAtual) {  /**< Outra tela estava sendo exibida, redesenha tudo */
+        ssd1306_screen_invalidate(tela);
+        telaAtual = tela;
     }
+    ssd1306_screen_render_with(&display, tela, ssd1306_manager_flush_cb, &gerenciadorDisplays);  /**< Redesenha e enfileira apenas o que mudou */
 }
 
 
 /**
- * @brief Função para centralizar o texto na tela do display SSD1306.
- * 
- * O texto é centralizado na linha especificada com base na largura do texto e da tela.
- * 
- * @param texto O texto a ser exibido.
- * @param linha A linha onde o texto será exibido.
- */
-void centralizarTexto(const char *texto, int linha) {
-    int larguraTexto = strlen(texto) * 6;  /**< Largura do texto em pixels */
-    int posX = (SCREEN_WIDTH - larguraTexto) / 2;  /**< Calcula a posição X para centralizar */
-    ssd1306_draw_string(&display, posX, linha, 1, texto);  /**< Exibe o texto na tela */
-}
-
-
-/**
- * @brief Função para exibir as informações no display.
- * 
- * Essa função exibe os dados atuais do sistema, incluindo o percentual de ocupação da lixeira, 
- * a distância medida pelo sensor e o estado do modo noturno.
- */
-void displayInfos(){
-    if (sistema.funcionando) {  /**< Se o sistema está funcionando */
-        centralizarTexto("SMIL", 0);  /**< Exibe que o título do projeto */
-
-        char textoOcupacao[32];
-        snprintf(textoOcupacao, sizeof(textoOcupacao), "Ocupacao: %.1f%%", sistema.ocupacao);  
-        centralizarTexto(textoOcupacao, 16);  /**< Exibe a ocupação da lixeira */
-
-        char textoDistancia[32];
-        snprintf(textoDistancia, sizeof(textoDistancia), "Distancia: %.1f Cm", sistema.distancia);  
-        centralizarTexto(textoDistancia, 32);  /**< Exibe a distância medida pelo sensor */
-
-    } else {  
-        centralizarTexto("SENSOR: Desativado", SCREEN_HEIGHT / 2 - 8);  /**< Exibe que o sensor está desativado */
-    }
-}
-
-
-/**
- * @brief Função para exibir o status do modo noturno no display.
- * 
- * A função exibe a opção de ativar ou desativar o modo noturno e destaca a opção selecionada.
+ * @brief Função para atualizar o display com as informações do sistema.
  * 
- * @note A função usa a variável 'sistema.modoNoturnoAtivado' para determinar o estado atual 
- *       do modo noturno e exibe a mensagem correspondente.
+ * A função exibe informações sobre o funcionamento do sensor, a ocupação da lixeira,
+ * a distância medida e o status do modo noturno. Ao trocar de tela o display é
+ * redesenhado por inteiro; depois disso apenas os widgets alterados são enviados.
+ * Os envios dos dois displays são enfileirados no gerenciador, que os intercala
+ * no barramento via DMA enquanto o laço principal continua. Com o display principal
+ * desligado por inatividade a tela dele não é desenhada nem enviada; os widgets
+ * continuam marcados como alterados e são enviados quando ele volta a ligar.
  */
-void displayModo() {
-    char modoTextoNormal[32];
-    char modoTextoNoturno[32];
-
-    centralizarTexto("MODO", 0);
-
-    // Formata as strings para exibir as opções "Normal" e "Noturno"
-    snprintf(modoTextoNormal, sizeof(modoTextoNormal), "Normal");
-    snprintf(modoTextoNoturno, sizeof(modoTextoNoturno), "Noturno");
-
-    // Exibe a seta ao lado da opção selecionada
-    if (sistema.modoNoturnoAtivado) {  // Se o modo noturno estiver ativado
-        centralizarTexto("Normal", 16);  // Exibe "Normal" na linha 16
-        centralizarTexto("-> Noturno", 32);  // Exibe "Noturno" na linha 32 com a seta à esquerda
-    } else {  // Se o modo normal estiver ativado
-        centralizarTexto("-> Normal", 16);  // Exibe "Normal" na linha 16 com a seta à esquerda
-        centralizarTexto("Noturno", 32);  // Exibe "Noturno" na linha 32
-    }
-}
-
+void atualizarDisplay() {
+    ssd1306_manager_run(&gerenciadorDisplays);  /**< Termina os envios anteriores antes de desenhar nos buffers */
 
-/**
- * @brief Função para exibir os gráficos de ocupação e distância no display SSD1306.
- * 
- * A função desenha barras horizontais representando a ocupação e a distância em gráficos.
- * 
- */
-void displayGraficos() {
-    char textoOcupacao[32];  /**< String para armazenar o texto da porcentagem de ocupação */
-    char textoDistancia[32];  /**< String para armazenar o texto da distância */
-
-    // Definir as dimensões dos gráficos (tamanho da barra e posição inicial)
-    int alturaGrafico = 10;  /**< Altura fixa para as barras horizontais (pode ser ajustada) */
-    int larguraMaximaGrafico = SCREEN_WIDTH - 20;  /**< Largura máxima da barra (ajustada com borda de 10 pixels em cada lado) */
-
-    // Calcular a largura das barras baseadas na ocupação e distância
-    int larguraOcupacao = (int)(sistema.ocupacao / 100.0 * larguraMaximaGrafico);  /**< Calcula a largura da barra da ocupação */
-    int larguraDistancia = (int)(sistema.distancia / ALTURA_MAX_LIXEIRA * larguraMaximaGrafico);  /**< Calcula a largura da barra da distância */
-
-    // Desenha o gráfico de ocupação (barra horizontal)
-    for (int x = 10; x < 10 + larguraOcupacao; x++) {  /**< Itera ao longo da largura da barra de ocupação */
-        for (int y = 20; y < 20 + alturaGrafico; y++) {  /**< Desenha a barra no Y = 20 (altura do gráfico) */
-            ssd1306_draw_pixel(&display, x, y);  /**< Desenha o pixel */
-        }
+    if (ssd1306_power_update(&energiaDisplay)) {  /**< Escurece, desliga ou acorda o display conforme a última entrada */
+        atualizarTelaPrincipal();
     }
 
-    // Desenha o gráfico de distância (barra horizontal)
-    for (int x = 10; x < 10 + larguraDistancia; x++) {  /**< Itera ao longo da largura da barra de distância */
-        for (int y = 40; y < 40 + alturaGrafico; y++) {  /**< Desenha a barra no Y = 40 (altura do gráfico) */
-            ssd1306_draw_pixel(&display, x, y);  /**< Desenha o pixel */
-        }
+    if (compartimentoPresente) {  /**< O display do compartimento mostra sempre a ocupação */
+        ssd1306_screen_render_with(&displayCompartimento, displayTelaCompartimento(), ssd1306_manager_flush_cb, &gerenciadorDisplays);
     }
 
-    // Exibe o texto "Ocupação %" no topo da tela
-    centralizarTexto("Ocupacao %", 0);  /**< Centraliza o texto "Ocupacao %" no topo da tela */
-
-    // Exibe a porcentagem de ocupação no centro da tela, sobre o gráfico
-    snprintf(textoOcupacao, sizeof(textoOcupacao), "%.1f%%", sistema.ocupacao);  /**< Converte o valor da ocupação para string */
-    
-    // Centraliza o texto da porcentagem no centro do display, acima do gráfico de ocupação
-    int textoLargura = strlen(textoOcupacao) * 6;  /**< Calcula a largura do texto da ocupação */
-    int posX = (SCREEN_WIDTH - textoLargura) / 2;  /**< Calcula a posição X para centralizar o texto */
-    int posY = 10;  /**< Posição para o texto da ocupação */
-    uint32_t scale = 1;  /**< Escala do texto (1 é o tamanho normal) */
-    ssd1306_draw_string(&display, posX, posY, scale, textoOcupacao);  /**< Desenha o texto da porcentagem */
-
-    // Exibe o texto "Distância" no gráfico de distância
-    centralizarTexto("Distancia Cm", 30);  /**< Texto "Distancia" um pouco mais abaixo */
-
-    // Exibe a distância no centro da tela, sobre o gráfico de distância
-    snprintf(textoDistancia, sizeof(textoDistancia), "%.1f cm", sistema.distancia);  /**< Converte o valor da distância para string */
-    
-    // Centraliza o texto da distância no centro do display, acima do gráfico de distância
-    textoLargura = strlen(textoDistancia) * 6;  /**< Calcula a largura do texto da distância */
-    posX = (SCREEN_WIDTH - textoLargura) / 2;  /**< Calcula a posição X para centralizar o texto */
-    posY = 50;  /**< Posição para o texto da distância */
-
-    ssd1306_draw_string(&display, posX, posY, scale, textoDistancia);  /**< Desenha o texto da distância */
+    ssd1306_manager_poll(&gerenciadorDisplays);  /**< Inicia os envios */
 }
 
 
 /**
- * @brief Função para atualizar o display com as informações do sistema.
+ * @brief Função para relatar o uso do barramento I2C pelos displays.
  * 
- * A função limpa o display e exibe informações sobre o funcionamento do sensor,
- * a ocupação da lixeira, a distância medida e o status do modo noturno.
+ * Exibe, para cada display, as atualizações enviadas e a latência entre enfileirar
+ * e concluir um envio, além da ocupação do barramento, e reinicia as estatísticas.
  */
-void atualizarDisplay() {
-    ssd1306_clear(&display);  /**< Limpa o display */
-
-    switch ((secaoAtual)){
-        case SECAO_PRINCIPAL:
-            displayInfos();  /**< Exibe as informações do sistema */
-            break;
-
-        case SECAO_GRAFICOS:
-            displayGraficos();  /**< Exibe os gráficos de ocupação e distância */
-            break;
-
-        case SECAO_TENDENCIAS:
-            displayGraficoTendencia();  /**< Desenha o gráfico de tendência */
-            break;
-
-        case SECAO_MODO_NOTURNO:
-            displayModo();  /**< Exibe o status do modo noturno */
-            break;
-
-        default:
-            break;
+void relatarDisplays() {
+    ssd1306_t *displays[] = {&display, &displayCompartimento};
+    const char *nomes[] = {"principal", "compartimento"};
+
+    for (int i = 0; i < (compartimentoPresente ? 2 : 1); i++) {
+        const ssd1306_manager_stats_t *estatisticas = ssd1306_manager_stats(&gerenciadorDisplays, displays[i]);
+        printf("Display %s: %lu envios, %lu bytes, latencia %lu us (max %lu us)\n", nomes[i],
+               (unsigned long)estatisticas->flushes, (unsigned long)estatisticas->bytes,
+               (unsigned long)estatisticas->last_latency_us, (unsigned long)estatisticas->max_latency_us);
     }
-    ssd1306_show(&display);  /**< Atualiza o display com as informações */
+    const ssd1306_power_stats_t *energia = ssd1306_power_stats(&energiaDisplay);
+    printf("Display principal: ligado %lu s, escurecido %lu s, desligado %lu s, %lu despertares, %lu quadros sem envio\n",
+           (unsigned long)(energia->on_us / 1000000), (unsigned long)(energia->dim_us / 1000000),
+           (unsigned long)(energia->off_us / 1000000), (unsigned long)energia->wakes, (unsigned long)energia->skipped);
+    printf("Barramento I2C ocupado %lu.%lu%% do tempo\n",
+           (unsigned long)ssd1306_manager_bus_load(&gerenciadorDisplays, i2c1) / 10,
+           (unsigned long)ssd1306_manager_bus_load(&gerenciadorDisplays, i2c1) % 10);
+
+    ssd1306_manager_reset_stats(&gerenciadorDisplays);
 }
 
 
@@ -371,17 +227,18 @@ void atualizarDisplay() {
  * @brief Função para ajustar o brilho global dos LEDs.
  * 
  * A função altera o brilho dos LEDs de acordo com o valor fornecido, garantindo que o brilho
- * esteja dentro dos limites definidos (0 a 7).
+ * esteja dentro dos limites definidos (0 a 255).
  * 
  * @param ajuste O valor a ser somado ou subtraído ao brilho atual.
  */
 void ajustarBrilho(int ajuste) {
     sistema.brilho += ajuste; /**< Modifica a intensidade do brilho de acordo com o valor do ajuste */ 
 
-    if (sistema.brilho > 7) sistema.brilho = 7;  
-    if (sistema.brilho < 0) sistema.brilho = 0; /**< Garante que o brilho não seja maior que 7 e menor que 0 */
+    if (sistema.brilho > 255) sistema.brilho = 255;  
+    if (sistema.brilho < 0) sistema.brilho = 0; /**< Garante que o brilho não seja maior que 255 e menor que 0 */
 
-    ws2812b_set_global_dimming(sistema.brilho);  /**< Altera a intensidade global dos leds */
+    ws2812b_set_brightness(sistema.brilho);  /**< Altera a intensidade global dos leds */
+    ws2812b_render();  /**< Reenvia a cor atual com o novo brilho */
 
     printf("Brilho Ajustado Para: %d\n", sistema.brilho);  
 }
@@ -429,10 +286,12 @@ void verificarJoystickX() {
     uint16_t vrx = ler_joystick_x();  /**< Lê o valor do eixo X do joystick */
 
     if (vrx > JOYSTICK_VRX_MAX) {  /**< Se o valor do eixo X for maior que o máximo (movimento para a direita) */
+        ssd1306_power_activity(&energiaDisplay);  /**< Qualquer movimento acorda o display */
         secaoAtual = (secaoAtual + 1) % 4;  /**< Avança para a próxima seção (circular com 4 seções) */
         sleep_ms(150);  /**< Delay para evitar mudanças rápidas */
     }
     else if (vrx < JOYSTICK_VRX_MIN) {  /**< Se o valor do eixo X for menor que o mínimo (movimento para a esquerda) */
+        ssd1306_power_activity(&energiaDisplay);
         secaoAtual = (secaoAtual == 0) ? 3 : secaoAtual - 1;  /**< Volta para a seção anterior (circular com 4 seções) */
         sleep_ms(150);  /**< Delay para evitar mudanças rápidas */
     }
@@ -448,19 +307,23 @@ void verificarJoystickX() {
 void verificarJoystickY() {
     uint16_t vry = ler_joystick_y();  /**< Lê o valor do eixo Y do joystick */
 
-    if (vry > JOYSTICK_VRY_MAX) {  /**< Se o valor do eixo Y for maior que o máximo, diminui o brilho */
-        ajustarBrilho(-1);  
+    if (vry > JOYSTICK_VRY_MAX) {  /**< Se o valor do eixo Y for maior que o máximo, aumenta o brilho */
+        ssd1306_power_activity(&energiaDisplay);  /**< Qualquer movimento acorda o display */
+        ajustarBrilho(BRILHO_PASSO);  
         sleep_ms(150);  /**< Pequeno delay para evitar mudanças muito rápidas */
     } 
 
-    else if (vry < JOYSTICK_VRY_MIN) {  /**< Se o valor do eixo Y for menor que o mínimo, aumenta o brilho */
-        ajustarBrilho(1);  
+    else if (vry < JOYSTICK_VRY_MIN) {  /**< Se o valor do eixo Y for menor que o mínimo, diminui o brilho */
+        ssd1306_power_activity(&energiaDisplay);
+        ajustarBrilho(-BRILHO_PASSO);  
         sleep_ms(150);
     }
 
     if (!gpio_get(JOYSTICK_SW)) {  /**< Se o botão do joystick for pressionado, reseta o brilho para o valor padrão */
-        sistema.brilho = 6;  
-        ws2812b_set_global_dimming(sistema.brilho);  
+        ssd1306_power_activity(&energiaDisplay);
+        sistema.brilho = BRILHO_PADRAO;  
+        ws2812b_set_brightness(sistema.brilho);  
+        ws2812b_render();
         printf("Brilho resetado para: %d\n", sistema.brilho);  
         sleep_ms(300);  /**< Pequeno delay para evitar múltiplas leituras */
     }
@@ -475,6 +338,14 @@ void verificarJoystickY() {
  */
 void controlarModoNoturno() {
     sistema.modoNoturnoAtivado = !sistema.modoNoturnoAtivado;  /**< Verifica se o botão de modo noturno foi pressionado */
+
+    ssd1306_manager_run(&gerenciadorDisplays);  /**< Os comandos de contraste não podem interromper um envio em andamento */
+    if (sistema.modoNoturnoAtivado) {
+        ssd1306_power_set_contrast(&energiaDisplay, CONTRASTE_NOTURNO, CONTRASTE_NOTURNO_ESCURECIDO);
+    } else {
+        ssd1306_power_set_contrast(&energiaDisplay, CONTRASTE_NORMAL, CONTRASTE_ESCURECIDO);
+    }
+
     if (sistema.modoNoturnoAtivado) {
         printf("Modo Noturno Ativado");
     } else {
@@ -519,7 +390,9 @@ void inicializarPinos() {
     gpio_pull_up(JOYSTICK_SW);
 
     ws2812b_init(pio0, 7, 25); /**< Inicializa a matriz de LEDs WS2812B */
-    ws2812b_set_global_dimming(sistema.brilho); /**< Ajusta o brilho global dos LEDs */
+    ws2812b_matrix_init(5, 5, WS2812B_MATRIX_BITDOGLAB, WS2812B_ROTATE_0); /**< Mapeia as coordenadas (x, y) para a fiação em serpentina da BitDogLab */
+    ws2812b_set_brightness(sistema.brilho); /**< Ajusta o brilho global dos LEDs */
+    ws2812b_set_power_budget(CORRENTE_LEDS_MA); /**< Reduz os quadros que passariam da corrente máxima */
 
     i2c_init(i2c1, 400 * 1000); /**< Inicializa a comunicação I2C com a frequência de 400kHz */
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C); /**< Configura o pino SDA para função I2C */
@@ -552,6 +425,19 @@ int main() {
         printf("Falha ao inicializar o display\n");
         return 1; /**< Retorna 1 caso a inicialização do display falhe */
     }
+    ssd1306_manager_init(&gerenciadorDisplays);
+    ssd1306_manager_add(&gerenciadorDisplays, &display, i2c1);
+    ssd1306_power_init(&energiaDisplay, &display, CONTRASTE_NORMAL, CONTRASTE_ESCURECIDO, DISPLAY_ESCURECER_MS, DISPLAY_DESLIGAR_MS);
+
+    // O display do compartimento é opcional, só é usado se responder no endereço 0x3D
+    uint8_t resposta;
+    if (i2c_read_blocking(i2c1, SCREEN_ADDRESS_COMPARTIMENTO, &resposta, 1, false) >= 0 &&
+        ssd1306_init(&displayCompartimento, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_ADDRESS_COMPARTIMENTO, i2c1)) {
+        compartimentoPresente = ssd1306_manager_add(&gerenciadorDisplays, &displayCompartimento, i2c1);
+    }
+    printf("Display do compartimento %s\n", compartimentoPresente ? "encontrado" : "ausente");
+
+    inicializarTelas(); /**< Monta os widgets das telas do display */
 
     // Flags de controle de estado dos botões e do sistema
     bool ultimoEstadoBotao = false; /**< Armazena o último estado do botão de ativação */
@@ -560,12 +446,18 @@ int main() {
     bool ultimoEstadoBotaoModoNoturno = false; /**< Armazena o último estado do botão de modo noturno */
     bool botaoPressionadoModoNoturno = false; /**< Flag indicando se o botão de modo noturno foi pressionado */
 
+    int iteracoes = 0; /**< Contador de iterações para o relatório periódico dos displays */
+
+    uGRB32_t corLeds = GRB_BLACK; /**< Cor que os LEDs devem mostrar nesta iteração */
+    uGRB32_t corAtualLeds = 0xffffffff; /**< Cor enviada por último, inválida para forçar o primeiro envio */
+
     // Loop principal do sistema
     while (true) {
         bool estadoBotao = gpio_get(BUTTON_PIN); /**< Lê o estado atual do botão de ativação */
 
         // Verifica se o botão foi pressionado (transição de estado)
         if (estadoBotao && !ultimoEstadoBotao) botaoPressionado = true;
+        if (estadoBotao != ultimoEstadoBotao) ssd1306_power_activity(&energiaDisplay);  /**< Qualquer toque acorda o display */
         ultimoEstadoBotao = estadoBotao;
 
         // Alterna o estado de funcionamento do sistema ao pressionar o botão
@@ -579,6 +471,7 @@ int main() {
 
         // Verifica se o botão de modo noturno foi pressionado (transição de estado)
         if (estadoBotaoModoNoturno && !ultimoEstadoBotaoModoNoturno && secaoAtual == SECAO_MODO_NOTURNO) botaoPressionadoModoNoturno = true;
+        if (estadoBotaoModoNoturno != ultimoEstadoBotaoModoNoturno) ssd1306_power_activity(&energiaDisplay);
         ultimoEstadoBotaoModoNoturno = estadoBotaoModoNoturno;
 
         // Alterna o estado do modo noturno ao pressionar o botão
@@ -599,23 +492,30 @@ int main() {
 
             // Ajusta a cor dos LEDs conforme a ocupação da lixeira
             if (sistema.ocupacao < 65.0) {
-                ws2812b_fill_all(GRB_GREEN); /**< LEDs verdes indicam baixo nível de ocupação */
+                corLeds = GRB_GREEN; /**< LEDs verdes indicam baixo nível de ocupação */
             } else if (sistema.ocupacao < 85.0) {
-                ws2812b_fill_all(GRB_YELLOW); /**< LEDs amarelos indicam ocupação média */
+                corLeds = GRB_YELLOW; /**< LEDs amarelos indicam ocupação média */
             } else {
-                ws2812b_fill_all(GRB_RED); /**< LEDs vermelhos indicam alta ocupação */
+                corLeds = GRB_RED; /**< LEDs vermelhos indicam alta ocupação */
                 emitirAlertaSonoro(); /**< Emite um alerta sonoro se a ocupação for alta */
             }
-            ws2812b_render(); /**< Atualiza os LEDs com a cor definida */
 
         } else {
             atualizarDisplay(); /**< Atualiza o display para mostrar que o sistema está desligado */
-            ws2812b_fill_all(GRB_BLACK); /**< Desliga todos os LEDs */
-            ws2812b_render(); /**< Atualiza os LEDs para refletir a cor apagada */
+            corLeds = GRB_BLACK; /**< Desliga todos os LEDs */
+        }
+
+        // Os LEDs só são atualizados quando a cor muda, sem mudança a biblioteca não acorda a CPU
+        if (corLeds != corAtualLeds) {
+            ws2812b_fill_all(corLeds);
+            ws2812b_render(); /**< Atualiza os LEDs com a cor definida */
+            corAtualLeds = corLeds;
         }
 
         verificarJoystickY(); /**< Verifica o estado do joystick e ajusta o brilho */
         verificarJoystickX(); /**< Verifica o estado do joystick e alterna a tela */
+
+        if (++iteracoes % 100 == 0) relatarDisplays(); /**< Relata periodicamente o uso do barramento pelos displays */
         sleep_ms(100);  /**< Atraso de 100ms para evitar consumo desnecessário da CPU */
     }
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+/**
+ * @file smil_telas.c
+ * @brief Telas do display principal e do display do compartimento do SMIL.
+ */
+
+#include "smil_telas.h"
+#include "ssd1306_utf8.h"
+#include <stddef.h>
+
+// Vetor para armazenar as últimas medições de ocupação e distância
+float ocupacaoTrend[MAX_MEASUREMENTS];  /**< Buffer circular com as últimas medições de ocupação da lixeira */
+
+// Widgets de cada seção do display, redesenhados apenas quando o valor exibido muda
+const char *const opcoesModo[] = {"Normal", "Noturno"};  /**< Opções do seletor de modo */
+
+ssd1306_widget_t widgetsInfos[3];        /**< Título, ocupação e distância da seção principal */
+ssd1306_widget_t widgetsDesativado[1];   /**< Aviso de sensor desativado */
+ssd1306_widget_t widgetsGraficos[6];     /**< Títulos, valores e barras da seção de gráficos */
+ssd1306_widget_t widgetsTendencia[2];    /**< Título e gráfico da seção de tendências */
+ssd1306_widget_t widgetsModo[2];         /**< Título e seletor da seção de modo */
+ssd1306_widget_t widgetsCompartimento[3];  /**< Título, ocupação e barra do display do compartimento */
+
+ssd1306_screen_t telaInfos;       /**< Tela da seção principal */
+ssd1306_screen_t telaDesativado;  /**< Tela exibida na seção principal com o sensor desligado */
+ssd1306_screen_t telaGraficos;    /**< Tela da seção de gráficos */
+ssd1306_screen_t telaTendencia;   /**< Tela da seção de tendências */
+ssd1306_screen_t telaModo;        /**< Tela da seção de modo */
+ssd1306_screen_t telaCompartimento;  /**< Tela do display do compartimento */
+
+
+/**
+ * @brief Função para atualizar as medições de tendência.
+ * 
+ * A nova medição substitui a mais antiga no buffer circular do gráfico, sem deslocar
+ * o vetor. Na próxima atualização o gráfico desenhado é deslocado para a esquerda e
+ * apenas o segmento da nova medição é desenhado.
+ * 
+ * @param ocupacao Valor atual da ocupação a ser armazenado.
+ */
+void atualizarTendencias(float ocupacao) {
+    ssd1306_chart_push(&widgetsTendencia[1], ocupacao);  /**< Adiciona a medição ao gráfico de tendência */
+}
+
+
+/**
+ * @brief Função para montar os widgets de todas as telas do display.
+ * 
+ * Os textos fixos, as posições e os tamanhos são definidos uma única vez; depois
+ * disso as funções de exibição apenas atualizam os valores dos widgets.
+ */
+void inicializarTelas() {
+    int posYTexto = 5;  /**< Posição vertical do título acima do gráfico de tendência */
+    int alturaMaxima = SCREEN_HEIGHT - (posYTexto + 10);  /**< Altura máxima do gráfico abaixo do título */
+
+    ssd1306_label_setup(&widgetsInfos[0], 0, 0, SCREEN_WIDTH, "SMIL", SSD1306_ALIGN_CENTER);  /**< Título do projeto */
+    ssd1306_number_setup(&widgetsInfos[1], 0, 16, SCREEN_WIDTH, "Ocupação: %.1f%%", SSD1306_ALIGN_CENTER);  /**< Ocupação da lixeira */
+    ssd1306_number_setup(&widgetsInfos[2], 0, 32, SCREEN_WIDTH, "Distância: %.1f Cm", SSD1306_ALIGN_CENTER);  /**< Distância medida pelo sensor */
+    ssd1306_screen_setup(&telaInfos, widgetsInfos, 3);
+
+    ssd1306_label_setup(&widgetsDesativado[0], 0, SCREEN_HEIGHT / 2 - 8, SCREEN_WIDTH, "SENSOR: Desativado", SSD1306_ALIGN_CENTER);
+    ssd1306_screen_setup(&telaDesativado, widgetsDesativado, 1);
+
+    ssd1306_label_setup(&widgetsGraficos[0], 0, 0, SCREEN_WIDTH, "Ocupação %", SSD1306_ALIGN_CENTER);  /**< Título do gráfico de ocupação */
+    ssd1306_number_setup(&widgetsGraficos[1], 0, 10, SCREEN_WIDTH, "%.1f%%", SSD1306_ALIGN_CENTER);  /**< Porcentagem acima da barra */
+    ssd1306_bar_setup(&widgetsGraficos[2], 10, 20, SCREEN_WIDTH - 20, 10, 100.0);  /**< Barra de ocupação, com borda de 10 pixels em cada lado */
+    ssd1306_label_setup(&widgetsGraficos[3], 0, 30, SCREEN_WIDTH, "Distância Cm", SSD1306_ALIGN_CENTER);  /**< Título do gráfico de distância */
+    ssd1306_number_setup(&widgetsGraficos[4], 0, 50, SCREEN_WIDTH, "%.1f cm", SSD1306_ALIGN_CENTER);  /**< Distância abaixo da barra */
+    ssd1306_bar_setup(&widgetsGraficos[5], 10, 40, SCREEN_WIDTH - 20, 10, ALTURA_MAX_LIXEIRA);  /**< Barra de distância */
+    ssd1306_screen_setup(&telaGraficos, widgetsGraficos, 6);
+
+    ssd1306_label_setup(&widgetsTendencia[0], 0, posYTexto, SCREEN_WIDTH, "Ocupação Tendências", SSD1306_ALIGN_CENTER);
+    ssd1306_chart_setup(&widgetsTendencia[1], 10, posYTexto + 10, SCREEN_WIDTH - 19, alturaMaxima + 1,
+                        ocupacaoTrend, MAX_MEASUREMENTS, 100.0);  /**< Gráfico logo abaixo do título, usa ocupacaoTrend como buffer circular */
+    ssd1306_screen_setup(&telaTendencia, widgetsTendencia, 2);
+
+    ssd1306_label_setup(&widgetsModo[0], 0, 0, SCREEN_WIDTH, "MODO", SSD1306_ALIGN_CENTER);
+    ssd1306_selector_setup(&widgetsModo[1], 0, 16, SCREEN_WIDTH, 16, opcoesModo, 2);  /**< "Normal" na linha 16 e "Noturno" na linha 32 */
+    ssd1306_screen_setup(&telaModo, widgetsModo, 2);
+
+    ssd1306_label_setup(&widgetsCompartimento[0], 0, 0, SCREEN_WIDTH, "Compartimento", SSD1306_ALIGN_CENTER);
+    ssd1306_number_setup(&widgetsCompartimento[1], 0, 24, SCREEN_WIDTH, "%.0f%%", SSD1306_ALIGN_CENTER);  /**< Ocupação do compartimento */
+    ssd1306_bar_setup(&widgetsCompartimento[2], 0, 48, SCREEN_WIDTH, 16, 100.0);  /**< Barra de ocupação na largura toda */
+    ssd1306_screen_setup(&telaCompartimento, widgetsCompartimento, 3);
+
+    // Textos acentuados usam a fonte UTF-8 CP0-EU, a mesma da matriz de LEDs
+    ssd1306_widget_t *acentuados[] = {&widgetsInfos[1], &widgetsInfos[2], &widgetsGraficos[0], &widgetsGraficos[3], &widgetsTendencia[0]};
+    for (size_t i = 0; i < sizeof(acentuados) / sizeof(acentuados[0]); i++) {
+        acentuados[i]->draw_text = ssd1306_utf8_text;
+    }
+}
+
+
+/**
+ * @brief Função para atualizar o gráfico de tendência no display.
+ * 
+ * O gráfico representa a variação da ocupação ao longo das medições recentes,
+ * permitindo visualizar tendências de uso da lixeira. A cada nova medição registrada
+ * por atualizarTendencias, apenas o segmento mais recente é desenhado.
+ * 
+ * @return A tela de tendências.
+ */
+ssd1306_screen_t *displayGraficoTendencia() {
+    return &telaTendencia;
+}
+
+
+/**
+ * @brief Função para atualizar as informações da seção principal.
+ * 
+ * Essa função exibe os dados atuais do sistema, incluindo o percentual de ocupação da lixeira 
+ * e a distância medida pelo sensor, ou o aviso de sensor desativado.
+ * 
+ * @return A tela a ser exibida.
+ */
+ssd1306_screen_t *displayInfos(){
+    if (!sistema.funcionando) {  /**< Se o sistema não está funcionando, exibe que o sensor está desativado */
+        return &telaDesativado;
+    }
+
+    ssd1306_number_set(&widgetsInfos[1], sistema.ocupacao);  /**< Atualiza a ocupação da lixeira */
+    ssd1306_number_set(&widgetsInfos[2], sistema.distancia);  /**< Atualiza a distância medida pelo sensor */
+    return &telaInfos;
+}
+
+
+/**
+ * @brief Função para atualizar o status do modo noturno no display.
+ * 
+ * A função exibe a opção de ativar ou desativar o modo noturno e destaca a opção selecionada
+ * com uma seta à esquerda.
+ * 
+ * @note A função usa a variável 'sistema.modoNoturnoAtivado' para determinar o estado atual 
+ *       do modo noturno.
+ * 
+ * @return A tela de modo.
+ */
+ssd1306_screen_t *displayModo() {
+    ssd1306_selector_set(&widgetsModo[1], sistema.modoNoturnoAtivado ? 1 : 0);  /**< Seleciona "Noturno" ou "Normal" */
+    return &telaModo;
+}
+
+
+/**
+ * @brief Função para atualizar os gráficos de ocupação e distância no display SSD1306.
+ * 
+ * A função atualiza as barras horizontais e os textos que representam a ocupação e a distância.
+ * 
+ * @return A tela de gráficos.
+ */
+ssd1306_screen_t *displayGraficos() {
+    ssd1306_number_set(&widgetsGraficos[1], sistema.ocupacao);  /**< Porcentagem de ocupação */
+    ssd1306_bar_set(&widgetsGraficos[2], sistema.ocupacao);  /**< Largura da barra de ocupação */
+    ssd1306_number_set(&widgetsGraficos[4], sistema.distancia);  /**< Distância em cm */
+    ssd1306_bar_set(&widgetsGraficos[5], sistema.distancia);  /**< Largura da barra de distância */
+    return &telaGraficos;
+}
+
+
+/**
+ * @brief Função para atualizar a tela de uma seção com o estado atual do sistema.
+ * 
+ * @param secao Seção do display principal.
+ * @return A tela a ser exibida, ou NULL para uma seção desconhecida.
+ */
+ssd1306_screen_t *displaySecao(SecaoDisplay secao) {
+    switch (secao) {
+        case SECAO_PRINCIPAL:
+            return displayInfos();  /**< Exibe as informações do sistema */
+
+        case SECAO_GRAFICOS:
+            return displayGraficos();  /**< Exibe os gráficos de ocupação e distância */
+
+        case SECAO_TENDENCIAS:
+            return displayGraficoTendencia();  /**< Desenha o gráfico de tendência */
+
+        case SECAO_MODO_NOTURNO:
+            return displayModo();  /**< Exibe o status do modo noturno */
+
+        default:
+            return NULL;
+    }
+}
+
+
+/**
+ * @brief Função para atualizar a tela do display do compartimento.
+ * 
+ * O display do compartimento mostra sempre a ocupação da lixeira.
+ * 
+ * @return A tela do compartimento.
+ */
+ssd1306_screen_t *displayTelaCompartimento() {
+    ssd1306_number_set(&widgetsCompartimento[1], sistema.ocupacao);
+    ssd1306_bar_set(&widgetsCompartimento[2], sistema.ocupacao);
+    return &telaCompartimento;
+}
\ No newline at end of file
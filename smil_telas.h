@@ -0,0 +1,67 @@
+/**
+ * @file smil_telas.h
+ * @brief Telas do display principal e do display do compartimento do SMIL.
+ *
+ * As telas dependem apenas do estado em `sistema` e da biblioteca pico-ssd1306,
+ * sem acesso ao hardware, e podem ser desenhadas no host pelo transporte em
+ * memória (ver pico-ssd1306/test).
+ */
+
+#ifndef SMIL_TELAS_H
+#define SMIL_TELAS_H
+
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "ssd1306_widget.h"
+
+#define SCREEN_WIDTH 128      /**< Largura da tela do display */
+#define SCREEN_HEIGHT 64      /**< Altura da tela do display */
+
+#define ALTURA_MAX_LIXEIRA 120 /**< Altura máxima da lixeira em centímetros */
+#define MAX_MEASUREMENTS 10    /**< Número máximo de medições para as tendências */
+
+// Estrutura para representar o estado do sistema da lixeira
+typedef struct {
+    int brilho;               /**< Nível de brilho dos LEDs */
+    bool funcionando;         /**< Flag de funcionamento do sistema */
+    bool modoNoturnoAtivado;  /**< Flag do modo noturno ativado */
+    float distancia;          /**< Distância medida pelo sensor ultrassônico */
+    float ocupacao;           /**< Percentual de ocupação da lixeira */
+} SistemaLixeira;
+
+// Enumeração para representar as seções do display
+typedef enum {
+    SECAO_PRINCIPAL,  /**< Seção principal do display */
+    SECAO_GRAFICOS,   /**< Seção de gráficos do display */
+    SECAO_TENDENCIAS,  /**< Seção de tendências do display */
+    SECAO_MODO_NOTURNO, /**< Seção do modo noturno do display */
+} SecaoDisplay;
+
+extern SistemaLixeira sistema; /**< Estado exibido pelas telas, definido pela aplicação */
+
+
+/**
+ * @brief Função para montar os widgets de todas as telas do display.
+ */
+void inicializarTelas();
+
+/**
+ * @brief Função para atualizar as medições de tendência.
+ * @param ocupacao Valor atual da ocupação a ser armazenado.
+ */
+void atualizarTendencias(float ocupacao);
+
+/**
+ * @brief Função para atualizar a tela de uma seção com o estado atual do sistema.
+ * @param secao Seção do display principal.
+ * @return A tela a ser exibida, ou NULL para uma seção desconhecida.
+ */
+ssd1306_screen_t *displaySecao(SecaoDisplay secao);
+
+/**
+ * @brief Função para atualizar a tela do display do compartimento.
+ * @return A tela do compartimento.
+ */
+ssd1306_screen_t *displayTelaCompartimento();
+
+#endif
\ No newline at end of file